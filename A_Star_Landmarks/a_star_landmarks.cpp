@@ -0,0 +1,83 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "a_star_landmarks.h"
+using namespace std;
+
+int main() {
+    // A road-like grid: 1000 x 1000 intersections, streets in both directions
+    // with travel times 1..100
+    const uint32_t side = 1000, n = side * side;
+    mt19937_64 rng(17);
+    vector<CsrEdge<uint32_t, int32_t>> streets;
+    for (uint32_t r = 0; r < side; ++r) {
+        for (uint32_t c = 0; c < side; ++c) {
+            uint32_t v = r * side + c;
+            if (c + 1 < side) streets.push_back({v, v + 1, int32_t(1 + rng() % 100)});
+            if (r + 1 < side) streets.push_back({v, v + side, int32_t(1 + rng() % 100)});
+        }
+    }
+    CsrBuildOptions undirected;
+    undirected.symmetrize = true;
+    CsrGraph<> roads = CsrGraph<>::fromEdges(n, streets, undirected);
+    CsrGraph<> reverse = roads.reversed();
+    cout << "Road grid: " << roads.numVertices() << " vertices, " << roads.numEdges() << " edges" << endl;
+
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    auto start = chrono::steady_clock::now();
+    AltIndex<uint32_t, int32_t> built = AltIndex<uint32_t, int32_t>::build(roads, reverse, 16);
+    double buildMs = since(start);
+    const string path = "a_star_landmarks_demo.bin";
+    built.save(path);
+    start = chrono::steady_clock::now();
+    AltIndex<uint32_t, int32_t> index = AltIndex<uint32_t, int32_t>::map(path);
+    cout << "16 landmarks: built in " << buildMs << " ms, mapped in " << since(start) << " ms" << endl;
+    cout << "Landmarks:";
+    for (size_t i = 0; i < index.numLandmarks(); ++i) {
+        cout << " (" << index.landmark(i) / side << "," << index.landmark(i) % side << ")";
+    }
+    cout << endl;
+
+    // Point-to-point queries between random intersections
+    const int queries = 200;
+    vector<pair<uint32_t, uint32_t>> pairs(queries);
+    for (auto& q : pairs) q = {uint32_t(rng() % n), uint32_t(rng() % n)};
+    DijkstraSearch<uint32_t, int32_t> forward(roads), backward(reverse);
+    AltSearch<uint32_t, int32_t> alt(roads, index);
+    vector<int64_t> expected(queries);
+    auto timeQueries = [&](const char* name, auto&& query) {
+        start = chrono::steady_clock::now();
+        size_t settled = 0;
+        bool same = true;
+        for (int i = 0; i < queries; ++i) {
+            auto [distance, count] = query(pairs[i].first, pairs[i].second);
+            settled += count;
+            if (name[0] == 'D') expected[i] = distance;
+            same = same && distance == expected[i];
+        }
+        cout << "  " << name << since(start) / queries << " ms, " << settled / queries << " settled per query, same: "
+             << (same ? "yes" : "no") << endl;
+    };
+    cout << "Point-to-point, average of " << queries << " queries:" << endl;
+    timeQueries("Dijkstra, stop at target: ", [&](uint32_t s, uint32_t t) {
+        forward.run(s, t);
+        return make_pair(forward.distance(t), forward.settledCount());
+    });
+    timeQueries("bidirectional Dijkstra:   ", [&](uint32_t s, uint32_t t) {
+        ShortestPath<uint32_t, int64_t> p = bidirectionalShortestPath<uint32_t, int32_t>(forward, backward, s, t);
+        return make_pair(p.distance, p.settled);
+    });
+    timeQueries("ALT (A* with landmarks):  ", [&](uint32_t s, uint32_t t) {
+        ShortestPath<uint32_t, int64_t> p = alt.run(s, t);
+        return make_pair(p.distance, p.settled);
+    });
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Goal-directed point-to-point shortest paths with A*, landmarks and the
+// triangle inequality (ALT, Goldberg and Harrelson).
+//
+// Preprocessing picks a few landmarks L and stores d(L, v) and d(v, L) for
+// every vertex v, using Dijkstra on the graph and on its reverse. For a query
+// towards target t, the triangle inequality gives lower bounds
+//     d(v, t) >= d(L, t) - d(L, v)    and    d(v, t) >= d(v, L) - d(t, L)
+// and the largest of them over all landmarks is the A* heuristic h(v). A*
+// settles vertices in order of d(s, v) + h(v), so it heads towards the target
+// instead of growing a ball around the source, and stops when t settles.
+//
+// Landmarks are chosen greedily: each new one is the vertex farthest from
+// those already chosen, which puts them on the periphery where their bounds
+// are tightest. The tables are saved to a binary file that map() uses in place,
+// so a service has its heuristic as soon as the file is mapped.
+//
+// Bounds also prune: a vertex that a landmark reaches, while the landmark
+// cannot reach the target, cannot reach the target either (and likewise for
+// distances to the landmark).
+
+namespace alt_detail {
+
+constexpr char kMagic[8] = {'A', 'L', 'T', 'L', 'M', 'K', '1', '\0'};
+
+struct Header {
+    char magic[8];
+    uint64_t idSize;
+    uint64_t distanceSize;
+    uint64_t distanceIsFloat;
+    uint64_t vertices;
+    uint64_t landmarks;
+    uint64_t landmarksAt; // Byte positions of the two arrays
+    uint64_t tableAt;
+};
+
+// Distances between one vertex and one landmark.
+template <typename Distance>
+struct Bounds {
+    Distance from; // d(landmark, v)
+    Distance to;   // d(v, landmark)
+};
+
+} // namespace alt_detail
+
+template <typename Id, typename Weight>
+class AltIndex {
+public:
+    using Distance = DijkstraDistance<Weight>;
+    using Bounds = alt_detail::Bounds<Distance>;
+
+    AltIndex() = default;
+
+    // Picks count landmarks (farthest-first) and computes their tables.
+    // reverse must be graph.reversed().
+    static AltIndex build(const CsrGraph<Id, Weight>& graph, const CsrGraph<Id, Weight>& reverse, size_t count,
+                          ThreadPool& pool = defaultThreadPool()) {
+        size_t n = graph.numVertices();
+        count = std::min(count, n);
+        auto arrays = std::make_shared<OwnedArrays>();
+        arrays->table.resize(n * count);
+        DijkstraSearch<Id, Weight> search(graph);
+        std::vector<Distance> nearest(n, kDijkstraInfinity<Distance>);
+        // The first landmark is the vertex farthest from vertex 0
+        Id next = count ? farthest(search, 0, nearest) : 0;
+        for (size_t i = 0; i < count; ++i) {
+            arrays->landmarks.push_back(next);
+            search.run(next);
+            for (size_t v = 0; v < n; ++v) {
+                Distance d = search.distance(static_cast<Id>(v));
+                arrays->table[v * count + i].from = d;
+                nearest[v] = std::min(nearest[v], d);
+            }
+            next = argmax(nearest);
+        }
+        fillRows(reverse, arrays->landmarks, &Bounds::to, arrays->table, pool);
+        AltIndex index;
+        index.adopt(arrays, n);
+        return index;
+    }
+
+    // Tables for the given landmarks.
+    static AltIndex build(const CsrGraph<Id, Weight>& graph, const CsrGraph<Id, Weight>& reverse,
+                          const std::vector<Id>& landmarks, ThreadPool& pool = defaultThreadPool()) {
+        size_t n = graph.numVertices();
+        auto arrays = std::make_shared<OwnedArrays>();
+        arrays->landmarks = landmarks;
+        for (Id l : landmarks) {
+            if (l >= n) throw std::invalid_argument("ALT: landmark out of range");
+        }
+        arrays->table.resize(n * landmarks.size());
+        fillRows(graph, arrays->landmarks, &Bounds::from, arrays->table, pool);
+        fillRows(reverse, arrays->landmarks, &Bounds::to, arrays->table, pool);
+        AltIndex index;
+        index.adopt(arrays, n);
+        return index;
+    }
+
+    // Writes a header, the landmark ids and the table (vertex-major: the k
+    // entries of a vertex are adjacent), each starting on a page boundary.
+    void save(const std::string& path) const {
+        using namespace csr_graph_detail;
+        alt_detail::Header h{};
+        std::memcpy(h.magic, alt_detail::kMagic, sizeof(h.magic));
+        h.idSize = sizeof(Id);
+        h.distanceSize = sizeof(Distance);
+        h.distanceIsFloat = std::is_floating_point_v<Distance>;
+        h.vertices = n;
+        h.landmarks = k;
+        h.landmarksAt = roundUp(sizeof(h), kSectionAlign);
+        h.tableAt = roundUp(h.landmarksAt + k * sizeof(Id), kSectionAlign);
+        std::unique_ptr<std::FILE, FileCloser> f(std::fopen(path.c_str(), "wb"));
+        if (!f) throw std::runtime_error("ALT: cannot create " + path);
+        writeAt(f.get(), 0, &h, sizeof(h));
+        writeAt(f.get(), h.landmarksAt, landmarkData, k * sizeof(Id));
+        writeAt(f.get(), h.tableAt, tableData, n * k * sizeof(Bounds));
+        if (std::fflush(f.get()) != 0) throw std::runtime_error("ALT: write failed for " + path);
+    }
+
+    // Maps a file written by save(); the tables are used in place.
+    static AltIndex map(const std::string& path) {
+        using namespace csr_graph_detail;
+        auto mapping = std::make_shared<Mapping>(path);
+        alt_detail::Header h;
+        if (mapping->size() < sizeof(h)) throw std::runtime_error("ALT: " + path + " is too short");
+        std::memcpy(&h, mapping->data(), sizeof(h));
+        if (std::memcmp(h.magic, alt_detail::kMagic, sizeof(h.magic)) != 0) {
+            throw std::runtime_error("ALT: " + path + " is not a landmark file");
+        }
+        if (h.idSize != sizeof(Id) || h.distanceSize != sizeof(Distance) ||
+            h.distanceIsFloat != static_cast<uint64_t>(std::is_floating_point_v<Distance>)) {
+            throw std::runtime_error("ALT: id or distance type does not match");
+        }
+        // The landmark section bounds h.landmarks, so the row size below cannot overflow
+        uint64_t size = mapping->size();
+        bool fits = sectionFits(h.landmarksAt, h.landmarks, sizeof(Id), size) &&
+                    sectionFits(h.tableAt, h.vertices, h.landmarks * sizeof(Bounds), size);
+        if (!fits || h.landmarksAt % kSectionAlign || h.tableAt % kSectionAlign) {
+            throw std::runtime_error("ALT: " + path + " is truncated or corrupt");
+        }
+        AltIndex index;
+        index.n = h.vertices;
+        index.k = h.landmarks;
+        index.landmarkData = reinterpret_cast<const Id*>(mapping->data() + h.landmarksAt);
+        index.tableData = reinterpret_cast<const Bounds*>(mapping->data() + h.tableAt);
+        index.owner = std::move(mapping);
+        return index;
+    }
+
+    size_t numVertices() const { return n; }
+    size_t numLandmarks() const { return k; }
+    Id landmark(size_t i) const { return landmarkData[i]; }
+    const Bounds* bounds(Id v) const { return tableData + static_cast<size_t>(v) * k; }
+
+    // Lower bound on d(v, t), given bounds(t); kDijkstraInfinity if t is
+    // unreachable from v.
+    Distance lowerBound(Id v, const Bounds* target) const {
+        const Bounds* row = bounds(v);
+        Distance best = 0;
+        for (size_t i = 0; i < k; ++i) {
+            if (row[i].from != kDijkstraInfinity<Distance>) {
+                if (target[i].from == kDijkstraInfinity<Distance>) return kDijkstraInfinity<Distance>;
+                best = std::max(best, target[i].from - row[i].from);
+            }
+            if (target[i].to != kDijkstraInfinity<Distance>) {
+                if (row[i].to == kDijkstraInfinity<Distance>) return kDijkstraInfinity<Distance>;
+                best = std::max(best, row[i].to - target[i].to);
+            }
+        }
+        return best;
+    }
+
+private:
+    struct OwnedArrays {
+        std::vector<Id> landmarks;
+        std::vector<Bounds> table;
+    };
+
+    void adopt(const std::shared_ptr<OwnedArrays>& arrays, size_t vertices) {
+        n = vertices;
+        k = arrays->landmarks.size();
+        landmarkData = arrays->landmarks.data();
+        tableData = arrays->table.data();
+        owner = arrays;
+    }
+
+    static Id argmax(const std::vector<Distance>& values) {
+        return static_cast<Id>(std::max_element(values.begin(), values.end()) - values.begin());
+    }
+
+    static Id farthest(DijkstraSearch<Id, Weight>& search, Id from, std::vector<Distance>& scratch) {
+        search.run(from);
+        for (size_t v = 0; v < scratch.size(); ++v) scratch[v] = search.distance(static_cast<Id>(v));
+        Id far = argmax(scratch);
+        std::fill(scratch.begin(), scratch.end(), kDijkstraInfinity<Distance>);
+        return far;
+    }
+
+    // One Dijkstra run per landmark, in parallel; the distances go to the
+    // given field of each table entry.
+    static void fillRows(const CsrGraph<Id, Weight>& graph, const std::vector<Id>& landmarks, Distance Bounds::*field,
+                         std::vector<Bounds>& table, ThreadPool& pool) {
+        size_t count = landmarks.size();
+        pool.parallelFor(count, [&](size_t i) {
+            DijkstraSearch<Id, Weight> search(graph);
+            search.run(landmarks[i]);
+            for (size_t v = 0; v < graph.numVertices(); ++v) {
+                table[v * count + i].*field = search.distance(static_cast<Id>(v));
+            }
+        });
+    }
+
+    size_t n = 0, k = 0;
+    const Id* landmarkData = nullptr;
+    const Bounds* tableData = nullptr;
+    std::shared_ptr<const void> owner; // OwnedArrays or a file mapping
+};
+
+// A* search with the ALT heuristic; reuse one object for many queries.
+template <typename Id, typename Weight>
+class AltSearch {
+public:
+    using Distance = DijkstraDistance<Weight>;
+
+    AltSearch(const CsrGraph<Id, Weight>& graph, const AltIndex<Id, Weight>& index)
+        : graph(graph), index(index), heap(graph.numVertices()), dist(graph.numVertices(), kDijkstraInfinity<Distance>),
+          potential(graph.numVertices()), parentOf(graph.numVertices(), kDijkstraNone<Id>) {
+        if (index.numVertices() != graph.numVertices()) throw std::invalid_argument("ALT: index is for another graph");
+    }
+
+    ShortestPath<Id, Distance> run(Id source, Id target) {
+        for (Id v : touched) dist[v] = kDijkstraInfinity<Distance>;
+        touched.clear();
+        heap.clear();
+        ShortestPath<Id, Distance> result;
+        const auto* goal = index.bounds(target);
+        Distance h = index.lowerBound(source, goal);
+        if (h == kDijkstraInfinity<Distance>) return result;
+        touched.push_back(source);
+        dist[source] = 0;
+        potential[source] = h;
+        parentOf[source] = source;
+        heap.push(source, h);
+        while (!heap.empty()) {
+            Id u = heap.pop().second;
+            ++result.settled;
+            if (u == target) break;
+            for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+                Weight w = graph.weight(e);
+                if constexpr (std::is_signed_v<Weight>) {
+                    if (w < 0) throw std::invalid_argument("ALT: negative edge weight");
+                }
+                Id v = graph.target(e);
+                Distance nd = dist[u] + static_cast<Distance>(w);
+                if (!(nd < dist[v])) continue;
+                if (dist[v] == kDijkstraInfinity<Distance>) {
+                    potential[v] = index.lowerBound(v, goal);
+                    touched.push_back(v);
+                }
+                if (potential[v] == kDijkstraInfinity<Distance>) continue; // v cannot reach target
+                dist[v] = nd;
+                parentOf[v] = u;
+                heap.push(v, nd + potential[v]);
+            }
+        }
+        if (dist[target] == kDijkstraInfinity<Distance>) return result;
+        result.distance = dist[target];
+        for (Id v = target;; v = parentOf[v]) {
+            result.path.push_back(v);
+            if (v == source) break;
+        }
+        std::reverse(result.path.begin(), result.path.end());
+        return result;
+    }
+
+private:
+    const CsrGraph<Id, Weight>& graph;
+    const AltIndex<Id, Weight>& index;
+    IndexedDaryHeap<Id, Distance> heap;
+    std::vector<Distance> dist, potential;
+    std::vector<Id> parentOf;
+    std::vector<Id> touched;
+};
@@ -1,6 +1,13 @@
 #include <iostream>
 #include <vector>
 #include <climits>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "bellman_ford_algorithm.h"
 using namespace std;
 
 struct Edge {
@@ -8,19 +15,23 @@ struct Edge {
 };
 
 void bellmanFord(int V, vector<Edge>& edges, int start) {
-    vector<int> dist(V, INT_MAX);
+    vector<long long> dist(V, LLONG_MAX);
     dist[start] = 0;
 
-    for (int i = 1; i < V; ++i) {
+    bool changed = true;
+    for (int i = 1; i < V && changed; ++i) {
+        changed = false; // Stop early once a pass changes nothing
         for (const auto& edge : edges) {
-            if (dist[edge.src] != INT_MAX && dist[edge.src] + edge.weight < dist[edge.dest]) {
+            if (dist[edge.src] != LLONG_MAX && dist[edge.src] + edge.weight < dist[edge.dest]) {
                 dist[edge.dest] = dist[edge.src] + edge.weight;
+                changed = true;
             }
         }
     }
 
+    // Only a pass V that still changes something means a negative cycle
     for (const auto& edge : edges) {
-        if (dist[edge.src] != INT_MAX && dist[edge.src] + edge.weight < dist[edge.dest]) {
+        if (changed && dist[edge.src] != LLONG_MAX && dist[edge.src] + edge.weight < dist[edge.dest]) {
             cout << "Graph contains a negative-weight cycle!" << endl;
             return;
         }
@@ -32,6 +43,139 @@ void bellmanFord(int V, vector<Edge>& edges, int start) {
     }
 }
 
+// The same algorithm on the shared CSR graph type, with the engine in
+// bellman_ford_algorithm.h: it also reports where a negative cycle is
+void bellmanFord(const CsrGraph<>& graph, uint32_t start) {
+    BellmanFordResult<uint32_t, int64_t> result = bellmanFord(graph, vector<uint32_t>{start});
+    if (!result.negativeCycle.empty()) {
+        cout << "Graph contains a negative-weight cycle:";
+        for (uint32_t v : result.negativeCycle) cout << " " << v << " ->";
+        cout << " " << result.negativeCycle[0] << endl;
+        return;
+    }
+
+    cout << "Vertex \tDistance from Source (CSR)\n";
+    for (size_t i = 0; i < result.distance.size(); ++i) {
+        cout << i << " \t" << result.distance[i] << endl;
+    }
+}
+
+static double since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Negative weights without negative cycles: w(u, v) + p(u) - p(v) for random
+// non-negative w and potentials p, checked against dijkstra() on w
+void negativeWeightDemo() {
+    const size_t n = size_t(1) << 20, m = size_t(1) << 23;
+    mt19937_64 rng(20);
+    vector<int32_t> potential(n);
+    for (int32_t& p : potential) p = int32_t(rng() % 1000);
+    vector<CsrEdge<uint32_t, int32_t>> edges(m);
+    for (auto& e : edges) e = {uint32_t(rng() % n), uint32_t(rng() % n), int32_t(1 + rng() % 1000)};
+    CsrGraph<> original = CsrGraph<>::fromEdges(n, edges);
+    for (auto& e : edges) e.weight += potential[e.source] - potential[e.target];
+    CsrGraph<> graph = CsrGraph<>::fromEdges(n, edges);
+    CsrGraph<> reverse = graph.reversed();
+    edges = {};
+    cout << "Random graph with negative weights: " << n << " vertices, " << graph.numEdges() << " edges" << endl;
+
+    vector<int64_t> expected = dijkstra(original, 0u).distance;
+    for (size_t v = 0; v < n; ++v) {
+        if (expected[v] != kDijkstraInfinity<int64_t>) expected[v] += potential[0] - potential[v];
+    }
+    auto report = [&](const char* name, double ms, const BellmanFordResult<uint32_t, int64_t>& result) {
+        cout << "  " << name << " " << ms << " ms, " << double(result.relaxations) / double(graph.numEdges())
+             << "x edges examined";
+        if (result.passes) cout << ", " << result.passes << " passes";
+        cout << ", correct: " << (result.distance == expected ? "yes" : "no") << endl;
+    };
+    BellmanFordOptions options;
+    auto start = chrono::steady_clock::now();
+    auto result = bellmanFord(graph, 0u, options);
+    report("passes, early exit:", since(start), result);
+    options.mode = BellmanFordMode::Spfa;
+    options.smallLabelFirst = options.largeLabelLast = false;
+    start = chrono::steady_clock::now();
+    result = bellmanFord(graph, 0u, options);
+    report("SPFA, FIFO queue:  ", since(start), result);
+    options.smallLabelFirst = options.largeLabelLast = true;
+    start = chrono::steady_clock::now();
+    result = bellmanFord(graph, 0u, options);
+    report("SPFA, SLF + LLL:   ", since(start), result);
+    for (size_t threads : {1, 2}) {
+        ThreadPool pool(threads);
+        start = chrono::steady_clock::now();
+        result = parallelBellmanFord(graph, reverse, 0u, pool);
+        report(threads == 1 ? "parallel, 1 thread:" : "parallel, 2 threads:", since(start), result);
+    }
+    cout << "  (the classic version makes " << n - 1 << " passes)" << endl;
+}
+
+// Currency arbitrage: an edge i -> j of weight -log(rate) per pair, so a cycle
+// of rates multiplying to more than 1 is a negative cycle
+void arbitrageDemo() {
+    const size_t n = 2000;
+    mt19937_64 rng(7);
+    uniform_real_distribution<double> price(0.01, 100.0);
+    vector<double> value(n);
+    for (double& v : value) v = price(rng);
+    const double fee = 0.001;
+    auto rate = [&](size_t i, size_t j) { return value[i] / value[j] * (1 - fee); };
+    vector<CsrEdge<uint32_t, double>> edges;
+    edges.reserve(n * (n - 1));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (i != j) edges.push_back({uint32_t(i), uint32_t(j), -log(rate(i, j))});
+        }
+    }
+    using Graph = CsrGraph<uint32_t, double>;
+    Graph fair = Graph::fromEdges(n, edges);
+    // One mispriced quote: 1742 -> 311 pays 0.5% too much
+    for (auto& e : edges) {
+        if (e.source == 1742 && e.target == 311) e.weight = -log(rate(1742, 311) * 1.005);
+    }
+    Graph mispriced = Graph::fromEdges(n, edges);
+    edges = {};
+    cout << "Currency market: " << n << " currencies, " << fair.numEdges() << " quotes" << endl;
+
+    auto print = [&](const Graph& graph, const char* name, double ms, const vector<uint32_t>& cycle) {
+        cout << "  " << name << ms << " ms, ";
+        if (cycle.empty()) {
+            cout << "no arbitrage" << endl;
+            return;
+        }
+        double weight = 0;
+        for (size_t i = 0; i < cycle.size(); ++i) {
+            uint32_t u = cycle[i], v = cycle[(i + 1) % cycle.size()];
+            for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+                if (graph.target(e) == v) weight += graph.weight(e);
+            }
+        }
+        double gain = exp(-weight);
+        cout << "arbitrage:";
+        for (uint32_t v : cycle) cout << " " << v << " ->";
+        cout << " " << cycle[0] << ", gain " << (gain - 1) * 100 << "%" << endl;
+    };
+    for (const Graph* graph : {&fair, &mispriced}) {
+        cout << (graph == &fair ? " Fair quotes:" : " One mispriced quote:") << endl;
+        BellmanFordOptions options;
+        auto start = chrono::steady_clock::now();
+        vector<uint32_t> cycle = findNegativeCycle(*graph, options);
+        print(*graph, "passes:   ", since(start), cycle);
+        options.mode = BellmanFordMode::Spfa;
+        start = chrono::steady_clock::now();
+        cycle = findNegativeCycle(*graph, options);
+        print(*graph, "SPFA:     ", since(start), cycle);
+        Graph reverse = graph->reversed();
+        vector<uint32_t> everyVertex(n);
+        for (size_t v = 0; v < n; ++v) everyVertex[v] = uint32_t(v);
+        start = chrono::steady_clock::now();
+        cycle = parallelBellmanFord(*graph, reverse, everyVertex).negativeCycle;
+        print(*graph, "parallel: ", since(start), cycle);
+    }
+}
+
 int main() {
     vector<Edge> edges = {
         {0, 1, -1}, {0, 2, 4}, {1, 2, 3}, {1, 3, 2}, {1, 4, 2},
@@ -40,6 +184,16 @@ int main() {
     int V = 5; // Number of vertices
     bellmanFord(V, edges, 0);
 
+    vector<CsrEdge<uint32_t, int32_t>> csrEdges;
+    for (const auto& edge : edges) csrEdges.push_back({uint32_t(edge.src), uint32_t(edge.dest), edge.weight});
+    bellmanFord(CsrGraph<>::fromEdges(V, csrEdges), 0);
+
+    csrEdges.push_back({2, 4, -5}); // Closes the cycle 4 -> 3 -> 2 -> 4 of weight -3
+    bellmanFord(CsrGraph<>::fromEdges(V, csrEdges), 0);
+
+    negativeWeightDemo();
+    arbitrageDemo();
+
     return 0;
 }
 
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Single-source shortest paths with negative weights on a CsrGraph, and
+// extraction of negative cycles.
+//
+// Modes:
+// - Passes: Bellman-Ford passes over all edges, updating distances in place,
+//   that stop as soon as a pass changes nothing. At most V - 1 passes are
+//   needed without a negative cycle, but usually far fewer.
+// - Spfa: only the out-edges of vertices whose distance changed are relaxed,
+//   from a FIFO queue of such vertices. Two queue heuristics reduce the number
+//   of times a vertex is scanned: SLF (small label first) puts a vertex at the
+//   front if its distance is below that of the current front, and LLL (large
+//   label last) moves front vertices above the average queued distance to the
+//   back before scanning.
+// - parallelBellmanFord: passes in which every vertex whose in-neighbors
+//   changed takes the best of its in-edges from the previous pass's distances
+//   (Jacobi style). Each vertex is written by one task only, so the pass needs
+//   no atomics for distances and parents.
+//
+// Distances are int64_t for integer weights (so long negative paths do not
+// overflow 32 bits) and double for floating-point ones.
+//
+// Negative cycles: every relaxation is a strict improvement, so a cycle in the
+// parent pointers always has negative weight. The searches look for one every
+// pass (every V relaxations for SPFA), which finds a negative cycle long before
+// the V-th pass that Bellman-Ford's bound would need, and report its vertices.
+
+template <typename Weight>
+using BellmanFordDistance = std::conditional_t<std::is_floating_point_v<Weight>, double, int64_t>;
+
+template <typename Distance>
+constexpr Distance kBellmanFordInfinity = std::numeric_limits<Distance>::max();
+
+template <typename Id>
+constexpr Id kBellmanFordNone = std::numeric_limits<Id>::max();
+
+enum class BellmanFordMode { Passes, Spfa };
+
+struct BellmanFordOptions {
+    BellmanFordMode mode = BellmanFordMode::Passes;
+    bool smallLabelFirst = true; // SPFA only
+    bool largeLabelLast = true;  // SPFA only
+};
+
+template <typename Id, typename Distance>
+struct BellmanFordResult {
+    std::vector<Distance> distance; // kBellmanFordInfinity if unreachable
+    std::vector<Id> parent;         // kBellmanFordNone for sources and unreachable vertices
+    std::vector<Id> negativeCycle;  // c0 -> c1 -> ... -> c0 if one is reachable; distances are then meaningless
+    size_t passes = 0;              // Passes over the edges (Passes and parallel modes)
+    uint64_t relaxations = 0;       // Edges examined
+};
+
+namespace bellman_ford_detail {
+
+// Finds a cycle in the parent pointers (each vertex points to its parent), in
+// edge order; empty if there is none. Every vertex is walked over at most once.
+template <typename Id>
+std::vector<Id> parentCycle(const std::vector<Id>& parent) {
+    size_t n = parent.size();
+    std::vector<size_t> walk(n, 0); // Walk that first reached the vertex, 0 if none
+    for (size_t start = 0; start < n; ++start) {
+        if (walk[start]) continue;
+        size_t v = start;
+        while (v != kBellmanFordNone<Id> && !walk[v]) {
+            walk[v] = start + 1;
+            v = parent[v];
+        }
+        if (v == kBellmanFordNone<Id> || walk[v] != start + 1) continue;
+        // v is on a cycle of this walk
+        std::vector<Id> cycle;
+        size_t u = v;
+        do {
+            cycle.push_back(static_cast<Id>(u));
+            u = parent[u];
+        } while (u != v);
+        std::reverse(cycle.begin(), cycle.end());
+        return cycle;
+    }
+    return {};
+}
+
+template <typename Id, typename Distance>
+void initialize(BellmanFordResult<Id, Distance>& result, size_t n, const std::vector<Id>& sources) {
+    result.distance.assign(n, kBellmanFordInfinity<Distance>);
+    result.parent.assign(n, kBellmanFordNone<Id>);
+    for (Id s : sources) {
+        if (s < n) result.distance[s] = 0;
+    }
+}
+
+template <typename Id, typename Weight>
+BellmanFordResult<Id, BellmanFordDistance<Weight>> passes(const CsrGraph<Id, Weight>& graph, const std::vector<Id>& sources) {
+    using Distance = BellmanFordDistance<Weight>;
+    size_t n = graph.numVertices();
+    BellmanFordResult<Id, Distance> result;
+    initialize(result, n, sources);
+    auto& dist = result.distance;
+    for (bool changed = true; changed;) {
+        changed = false;
+        ++result.passes;
+        for (size_t u = 0; u < n; ++u) {
+            if (dist[u] == kBellmanFordInfinity<Distance>) continue;
+            for (uint64_t e = graph.edgeBegin(static_cast<Id>(u)); e < graph.edgeEnd(static_cast<Id>(u)); ++e) {
+                Id v = graph.target(e);
+                Distance nd = dist[u] + static_cast<Distance>(graph.weight(e));
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    result.parent[v] = static_cast<Id>(u);
+                    changed = true;
+                }
+            }
+            result.relaxations += graph.degree(static_cast<Id>(u));
+        }
+        if (changed) {
+            result.negativeCycle = parentCycle(result.parent);
+            if (!result.negativeCycle.empty()) break;
+        }
+    }
+    return result;
+}
+
+template <typename Id, typename Weight>
+BellmanFordResult<Id, BellmanFordDistance<Weight>> spfa(const CsrGraph<Id, Weight>& graph, const std::vector<Id>& sources,
+                                                        const BellmanFordOptions& options) {
+    using Distance = BellmanFordDistance<Weight>;
+    size_t n = graph.numVertices();
+    BellmanFordResult<Id, Distance> result;
+    initialize(result, n, sources);
+    auto& dist = result.distance;
+    std::deque<Id> queue;
+    std::vector<uint8_t> queued(n, 0);
+    double queuedSum = 0; // Sum of queued distances, for LLL
+    auto enqueue = [&](Id v) {
+        queued[v] = 1;
+        queuedSum += static_cast<double>(dist[v]);
+        if (options.smallLabelFirst && !queue.empty() && dist[v] < dist[queue.front()]) queue.push_front(v);
+        else queue.push_back(v);
+    };
+    for (Id s : sources) {
+        if (s < n && !queued[s]) enqueue(s);
+    }
+    uint64_t sinceCheck = 0;
+    while (!queue.empty()) {
+        if (options.largeLabelLast) {
+            double average = queuedSum / static_cast<double>(queue.size());
+            // Bounded rotation: at least one vertex is at or below the average
+            for (size_t moved = 0; moved < queue.size() && static_cast<double>(dist[queue.front()]) > average; ++moved) {
+                queue.push_back(queue.front());
+                queue.pop_front();
+            }
+        }
+        Id u = queue.front();
+        queue.pop_front();
+        queued[u] = 0;
+        queuedSum -= static_cast<double>(dist[u]);
+        result.relaxations += graph.degree(u);
+        for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+            Id v = graph.target(e);
+            Distance nd = dist[u] + static_cast<Distance>(graph.weight(e));
+            if (!(nd < dist[v])) continue;
+            if (queued[v]) queuedSum += static_cast<double>(nd) - static_cast<double>(dist[v]);
+            dist[v] = nd;
+            result.parent[v] = u;
+            if (!queued[v]) enqueue(v);
+            if (++sinceCheck >= n) {
+                // Amortized: one O(V) parent-cycle search per V improvements
+                sinceCheck = 0;
+                result.negativeCycle = parentCycle(result.parent);
+                if (!result.negativeCycle.empty()) return result;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace bellman_ford_detail
+
+// Shortest distances from the nearest source; with every vertex as a source,
+// any negative cycle in the graph is found.
+template <typename Id, typename Weight>
+BellmanFordResult<Id, BellmanFordDistance<Weight>> bellmanFord(const CsrGraph<Id, Weight>& graph,
+                                                               const std::vector<Id>& sources,
+                                                               const BellmanFordOptions& options = {}) {
+    if (options.mode == BellmanFordMode::Spfa) return bellman_ford_detail::spfa(graph, sources, options);
+    return bellman_ford_detail::passes(graph, sources);
+}
+
+template <typename Id, typename Weight>
+BellmanFordResult<Id, BellmanFordDistance<Weight>> bellmanFord(const CsrGraph<Id, Weight>& graph, Id source,
+                                                               const BellmanFordOptions& options = {}) {
+    return bellmanFord(graph, std::vector<Id>{source}, options);
+}
+
+// A negative cycle anywhere in the graph (c0 -> c1 -> ... -> c0), or empty.
+template <typename Id, typename Weight>
+std::vector<Id> findNegativeCycle(const CsrGraph<Id, Weight>& graph, const BellmanFordOptions& options = {}) {
+    std::vector<Id> everyVertex(graph.numVertices());
+    for (size_t v = 0; v < everyVertex.size(); ++v) everyVertex[v] = static_cast<Id>(v);
+    return bellmanFord(graph, everyVertex, options).negativeCycle;
+}
+
+// Parallel passes; inGraph must be graph.reversed(). Only vertices with an
+// in-neighbor that changed in the previous pass are recomputed. Throws
+// std::invalid_argument if the graphs differ in size.
+template <typename Id, typename Weight>
+BellmanFordResult<Id, BellmanFordDistance<Weight>> parallelBellmanFord(const CsrGraph<Id, Weight>& graph,
+                                                                       const CsrGraph<Id, Weight>& inGraph,
+                                                                       const std::vector<Id>& sources,
+                                                                       ThreadPool& pool = defaultThreadPool()) {
+    using Distance = BellmanFordDistance<Weight>;
+    constexpr size_t kGrain = 1024;
+    size_t n = graph.numVertices();
+    if (inGraph.numVertices() != n || inGraph.numEdges() != graph.numEdges()) {
+        throw std::invalid_argument("parallelBellmanFord: inGraph must be graph.reversed()");
+    }
+    BellmanFordResult<Id, Distance> result;
+    bellman_ford_detail::initialize(result, n, sources);
+    std::vector<Distance> next(result.distance);
+    std::vector<uint8_t> changed(n, 0);
+    std::unique_ptr<std::atomic<uint8_t>[]> dirty(new std::atomic<uint8_t>[n]);
+    for (size_t v = 0; v < n; ++v) dirty[v].store(0, std::memory_order_relaxed);
+    for (Id s : sources) {
+        if (s < n) changed[s] = 1;
+    }
+    size_t tasks = (n + kGrain - 1) / kGrain;
+    std::vector<uint64_t> relaxations(tasks);
+    std::vector<uint8_t> anyChange(tasks);
+    for (bool more = true; more;) {
+        ++result.passes;
+        // Mark the out-neighbors of changed vertices
+        pool.parallelFor(n, [&](size_t u) {
+            if (!changed[u]) return;
+            for (Id v : graph.neighbors(static_cast<Id>(u))) dirty[v].store(1, std::memory_order_relaxed);
+        }, kGrain);
+        // Recompute marked vertices from the previous distances
+        std::fill(anyChange.begin(), anyChange.end(), 0);
+        pool.parallelFor(tasks, [&](size_t t) {
+            size_t end = std::min(n, (t + 1) * kGrain);
+            for (size_t v = t * kGrain; v < end; ++v) {
+                changed[v] = 0;
+                if (!dirty[v].load(std::memory_order_relaxed)) continue;
+                dirty[v].store(0, std::memory_order_relaxed);
+                Distance best = result.distance[v];
+                Id from = kBellmanFordNone<Id>;
+                for (uint64_t e = inGraph.edgeBegin(static_cast<Id>(v)); e < inGraph.edgeEnd(static_cast<Id>(v)); ++e) {
+                    Id u = inGraph.target(e);
+                    if (result.distance[u] == kBellmanFordInfinity<Distance>) continue;
+                    Distance nd = result.distance[u] + static_cast<Distance>(inGraph.weight(e));
+                    if (nd < best) {
+                        best = nd;
+                        from = u;
+                    }
+                }
+                relaxations[t] += inGraph.degree(static_cast<Id>(v));
+                if (from == kBellmanFordNone<Id>) continue;
+                next[v] = best;
+                result.parent[v] = from;
+                changed[v] = 1;
+                anyChange[t] = 1;
+            }
+        });
+        more = std::find(anyChange.begin(), anyChange.end(), 1) != anyChange.end();
+        if (!more) break;
+        // Copy the new distances of changed vertices back
+        pool.parallelFor(n, [&](size_t v) {
+            if (changed[v]) result.distance[v] = next[v];
+        }, kGrain);
+        result.negativeCycle = bellman_ford_detail::parentCycle(result.parent);
+        if (!result.negativeCycle.empty()) break;
+    }
+    for (uint64_t r : relaxations) result.relaxations += r;
+    return result;
+}
+
+template <typename Id, typename Weight>
+BellmanFordResult<Id, BellmanFordDistance<Weight>> parallelBellmanFord(const CsrGraph<Id, Weight>& graph,
+                                                                       const CsrGraph<Id, Weight>& inGraph, Id source,
+                                                                       ThreadPool& pool = defaultThreadPool()) {
+    return parallelBellmanFord(graph, inGraph, std::vector<Id>{source}, pool);
+}
@@ -1,5 +1,10 @@
 #include <iostream>
 #include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "binary_search.h"
 using namespace std;
 
 int binarySearch(const vector<int>& arr, int target) {
@@ -22,6 +27,50 @@ int main() {
     } else {
         cout << "Element not found!" << endl;
     }
+
+    // The same lookup on an Eytzinger index
+    EytzingerIndex<int> small(arr.begin(), arr.end());
+    cout << "Eytzinger index: " << target << (small.contains(target) ? " found" : " not found")
+         << " at index " << small.lowerBound(target) << endl;
+
+    // A table far larger than the caches
+    const size_t n = size_t(1) << 25, queries = size_t(1) << 22;
+    mt19937_64 rng(1);
+    vector<int32_t> keys(n);
+    for (auto& k : keys) k = static_cast<int32_t>(rng());
+    sort(keys.begin(), keys.end());
+    vector<int32_t> probes(queries);
+    for (auto& q : probes) q = static_cast<int32_t>(rng());
+
+    EytzingerIndex<int32_t> table(keys.begin(), keys.end());
+    vector<size_t> expected(queries), single(queries), batch(queries);
+    auto time = [&](auto&& fn) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return seconds * 1e9 / queries;
+    };
+    double stdNs = time([&] {
+        for (size_t i = 0; i < queries; ++i) expected[i] = lower_bound(keys.begin(), keys.end(), probes[i]) - keys.begin();
+    });
+    double singleNs = time([&] {
+        for (size_t i = 0; i < queries; ++i) single[i] = table.lowerBound(probes[i]);
+    });
+    double batchNs = time([&] { table.lowerBounds(probes.data(), queries, batch.data()); });
+    cout << queries << " lookups in " << n << " keys (ns per lookup):" << endl;
+    cout << "  std::lower_bound:          " << stdNs << endl;
+    cout << "  Eytzinger, one at a time:  " << singleNs << endl;
+    cout << "  Eytzinger, batch:          " << batchNs << endl;
+    cout << "Results match: " << (single == expected && batch == expected ? "yes" : "no") << endl;
+
+    // Plain binary search on the sorted array, many lookups interleaved
+    LowerBoundSearch<int32_t> search(keys.data(), keys.size());
+    vector<size_t> interleaved(queries);
+    interleavedSearch(search, probes.data(), queries, interleaved.data(), 16);
+    cout << "Interleaved binary search matches: " << (interleaved == expected ? "yes" : "no") << endl;
+    for (const InterleaveReport& r : profileInterleaving(search, probes.data(), queries)) {
+        cout << "  width " << r.width << ": " << r.lookupsPerSecond / 1e6 << " M lookups/s" << endl;
+    }
     return 0;
 }
 
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <vector>
+
+// Search helpers for sorted arrays: a generic branchless binary search, an
+// interleaving driver that overlaps the cache misses of many lookups, and a
+// static Eytzinger-layout index.
+
+// Branchless lower bound on a sorted range: the interval shrinks by half with
+// a conditional move instead of a branch. Equivalent to std::lower_bound.
+template <typename RandomIt, typename T, typename Compare = std::less<>>
+RandomIt lowerBound(RandomIt first, RandomIt last, const T& x, Compare cmp = Compare()) {
+    size_t len = static_cast<size_t>(last - first);
+    if (len == 0) return first;
+    RandomIt base = first;
+    while (len > 1) {
+        size_t half = len / 2;
+        base = cmp(base[half - 1], x) ? base + half : base;
+        len -= half;
+    }
+    return base + cmp(*base, x);
+}
+
+// Index of an element equal to x in the sorted range, or -1.
+template <typename RandomIt, typename T, typename Compare = std::less<>>
+ptrdiff_t binarySearch(RandomIt first, RandomIt last, const T& x, Compare cmp = Compare()) {
+    RandomIt it = lowerBound(first, last, x, cmp);
+    return it != last && !cmp(x, *it) ? it - first : -1;
+}
+
+// ---------------------------------------------------------------------------
+// Interleaved batch search
+//
+// A single lookup spends most of its time waiting for the next probe to
+// arrive from memory. A batch of lookups can instead be run as resumable state
+// machines: each step does one probe, prefetches the probe after it, and
+// hands control to the next lookup in flight. With W lookups in flight, W
+// cache misses overlap.
+//
+// A search plugs in by providing
+//     using Key; using State;
+//     void start(State&, const Key&) const;  // set up and prefetch the first probe
+//     bool step(State&) const;              // one probe; true when finished
+//     size_t result(const State&) const;
+// LowerBoundSearch below is the binary search; Jump_Search/ has one too.
+
+// lowerBound as a state machine. Once a step has chosen its half, the probe of
+// the next step is known and prefetched.
+template <typename T, typename Compare = std::less<>>
+class LowerBoundSearch {
+public:
+    using Key = T;
+    struct State {
+        const T* base;
+        size_t len;
+        T key;
+    };
+
+    LowerBoundSearch(const T* data, size_t n, Compare cmp = Compare()) : data(data), n(n), cmp(std::move(cmp)) {}
+
+    void start(State& s, const T& key) const {
+        s.base = data;
+        s.len = n;
+        s.key = key;
+        if (n > 1) __builtin_prefetch(data + n / 2 - 1);
+    }
+
+    bool step(State& s) const {
+        if (s.len <= 1) return true;
+        size_t half = s.len / 2;
+        s.base = cmp(s.base[half - 1], s.key) ? s.base + half : s.base;
+        s.len -= half;
+        if (s.len <= 1) return true;
+        __builtin_prefetch(s.base + s.len / 2 - 1);
+        return false;
+    }
+
+    size_t result(const State& s) const {
+        if (n == 0) return 0;
+        return static_cast<size_t>(s.base - data) + cmp(*s.base, s.key);
+    }
+
+private:
+    const T* data;
+    size_t n;
+    Compare cmp;
+};
+
+namespace binary_search_detail {
+
+template <size_t Width, typename Search>
+void interleave(const Search& search, const typename Search::Key* queries, size_t count, size_t* out) {
+    typename Search::State states[Width];
+    size_t owner[Width];
+    size_t next = 0, active = 0;
+    for (; active < Width && next < count; ++active, ++next) {
+        search.start(states[active], queries[next]);
+        owner[active] = next;
+    }
+    while (active > 0) {
+        for (size_t i = 0; i < active;) {
+            if (!search.step(states[i])) {
+                ++i;
+                continue;
+            }
+            out[owner[i]] = search.result(states[i]);
+            if (next < count) {
+                search.start(states[i], queries[next]);
+                owner[i] = next++;
+                ++i;
+            } else {
+                // Keep the live lookups packed at the front.
+                --active;
+                states[i] = states[active];
+                owner[i] = owner[active];
+            }
+        }
+    }
+}
+
+} // namespace binary_search_detail
+
+// Interleave widths supported by interleavedSearch.
+inline const std::vector<size_t>& interleaveWidths() {
+    static const std::vector<size_t> widths = {1, 2, 4, 8, 16, 32};
+    return widths;
+}
+
+// Runs search for every query with `width` lookups in flight (rounded down to
+// a supported width) and writes each result to out[i].
+template <typename Search>
+void interleavedSearch(const Search& search, const typename Search::Key* queries, size_t count, size_t* out,
+                       size_t width = 16) {
+    using binary_search_detail::interleave;
+    if (width >= 32) interleave<32>(search, queries, count, out);
+    else if (width >= 16) interleave<16>(search, queries, count, out);
+    else if (width >= 8) interleave<8>(search, queries, count, out);
+    else if (width >= 4) interleave<4>(search, queries, count, out);
+    else if (width >= 2) interleave<2>(search, queries, count, out);
+    else interleave<1>(search, queries, count, out);
+}
+
+struct InterleaveReport {
+    size_t width;
+    double lookupsPerSecond;
+};
+
+// Times interleavedSearch at every supported width on the given queries, so
+// callers can pick the best width for their machine and table size.
+template <typename Search>
+std::vector<InterleaveReport> profileInterleaving(const Search& search, const typename Search::Key* queries,
+                                                  size_t count) {
+    std::vector<InterleaveReport> report;
+    std::vector<size_t> out(count);
+    for (size_t width : interleaveWidths()) {
+        auto start = std::chrono::steady_clock::now();
+        interleavedSearch(search, queries, count, out.data(), width);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.push_back({width, seconds > 0 ? static_cast<double>(count) / seconds : 0});
+    }
+    return report;
+}
+
+// ---------------------------------------------------------------------------
+// Static search index over a sorted array, stored in Eytzinger (BFS) order.
+//
+// Node k has its children at 2k and 2k + 1, so the first levels of the tree
+// share a few hot cache lines, and the 4 to 16 descendants a few levels below
+// any node are contiguous. The search prefetches those descendants (at least
+// the grandchildren) while it compares the current node, and the descent is
+// branchless: k = 2k + (node < x).
+//
+// The tree is padded to a complete tree of 2^h - 1 nodes with copies of the
+// largest key. Every search then takes exactly h steps, and the h branch bits
+// of the final k are the number of keys smaller than x, i.e. the lower bound
+// rank in the original sorted array, without storing any rank table.
+namespace binary_search_detail {
+
+constexpr size_t kCacheLine = 64;
+
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kCacheLine)));
+    }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(kCacheLine)); }
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+// Descendants of node k that are prefetched: nodes [k * M, k * M + M) sit in
+// one cache line when M * sizeof(T) == 64; larger keys prefetch grandchildren.
+template <typename T>
+constexpr size_t prefetchFanout() {
+    size_t m = 4;
+    while (m * 2 * sizeof(T) <= kCacheLine) m *= 2;
+    return m;
+}
+
+inline size_t log2Floor(size_t x) {
+    return 63 - static_cast<size_t>(__builtin_clzll(x));
+}
+
+} // namespace binary_search_detail
+
+template <typename T, typename Compare = std::less<>>
+class EytzingerIndex {
+public:
+    // Builds the index from the sorted range [first, last).
+    template <typename It>
+    EytzingerIndex(It first, It last, Compare cmp = Compare()) : cmp(std::move(cmp)) {
+        std::vector<T> sorted(first, last);
+        n = sorted.size();
+        if (n == 0) return;
+        while ((size_t(1) << height) - 1 < n) ++height;
+        size_t leaves = size_t(1) << height;
+        tree.resize(leaves);
+        for (size_t r = 0; r + 1 < leaves; ++r) tree[slotOf(r)] = sorted[std::min(r, n - 1)];
+        tree[0] = sorted[0]; // Unused slot, keeps the array fully initialized
+    }
+
+    size_t size() const { return n; }
+
+    // Number of keys less than x, i.e. the std::lower_bound position in the
+    // sorted input.
+    size_t lowerBound(const T& x) const {
+        if (n == 0) return 0;
+        const T* t = tree.data();
+        size_t k = 1;
+        size_t level = 0;
+        for (; level < prefetchLevels(); ++level) {
+            __builtin_prefetch(t + k * kFanout);
+            k = 2 * k + cmp(t[k], x);
+        }
+        for (; level < height; ++level) k = 2 * k + cmp(t[k], x);
+        return std::min(k - (size_t(1) << height), n);
+    }
+
+    bool contains(const T& x) const {
+        size_t r = lowerBound(x);
+        return r < n && !cmp(x, at(r));
+    }
+
+    // Key of sorted rank r (0 <= r < size()).
+    const T& at(size_t r) const { return tree[slotOf(r)]; }
+
+    // Lower bounds of count queries. Queries are advanced level by level in
+    // groups, so the cache misses of a whole group are in flight at once
+    // instead of one after another.
+    void lowerBounds(const T* queries, size_t count, size_t* out) const {
+        constexpr size_t kGroup = 16;
+        if (n == 0) {
+            std::fill(out, out + count, 0);
+            return;
+        }
+        const T* t = tree.data();
+        size_t k[kGroup];
+        for (size_t base = 0; base < count; base += kGroup) {
+            size_t g = std::min(kGroup, count - base);
+            const T* q = queries + base;
+            for (size_t i = 0; i < g; ++i) k[i] = 1;
+            size_t level = 0;
+            for (; level < prefetchLevels(); ++level) {
+                for (size_t i = 0; i < g; ++i) {
+                    __builtin_prefetch(t + k[i] * kFanout);
+                    k[i] = 2 * k[i] + cmp(t[k[i]], q[i]);
+                }
+            }
+            for (; level < height; ++level) {
+                for (size_t i = 0; i < g; ++i) k[i] = 2 * k[i] + cmp(t[k[i]], q[i]);
+            }
+            for (size_t i = 0; i < g; ++i) out[base + i] = std::min(k[i] - (size_t(1) << height), n);
+        }
+    }
+
+private:
+    static constexpr size_t kFanout = binary_search_detail::prefetchFanout<T>();
+
+    // Levels whose prefetch target still lies inside the tree.
+    size_t prefetchLevels() const {
+        size_t skip = binary_search_detail::log2Floor(kFanout);
+        return height > skip ? height - skip : 0;
+    }
+
+    // Slot of sorted rank r: the leaf code 2^h + r with its trailing ones and
+    // the last left turn stripped off.
+    size_t slotOf(size_t r) const {
+        size_t code = (size_t(1) << height) + r;
+        return code >> (__builtin_ctzll(~code) + 1);
+    }
+
+    Compare cmp;
+    size_t n = 0;
+    size_t height = 0;
+    std::vector<T, binary_search_detail::CacheAlignedAllocator<T>> tree;
+};
@@ -1,6 +1,11 @@
 #include <iostream>
 #include <vector>
 #include <queue>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "breadth_first_search.h"
 using namespace std;
 
 void bfs(const vector<vector<int>>& graph, int start) {
@@ -23,6 +28,27 @@ void bfs(const vector<vector<int>>& graph, int start) {
     }
 }
 
+// The same traversal on the shared CSR graph type
+void bfs(const CsrGraph<>& graph, uint32_t start) {
+    vector<bool> visited(graph.numVertices(), false);
+    queue<uint32_t> q;
+    q.push(start);
+    visited[start] = true;
+
+    while (!q.empty()) {
+        uint32_t node = q.front();
+        q.pop();
+        cout << node << " ";
+
+        for (uint32_t neighbor : graph.neighbors(node)) {
+            if (!visited[neighbor]) {
+                q.push(neighbor);
+                visited[neighbor] = true;
+            }
+        }
+    }
+}
+
 int main() {
     vector<vector<int>> graph = {
         {1, 2},  // Node 0 is connected to 1 and 2
@@ -34,6 +60,59 @@ int main() {
 
     cout << "BFS Traversal: ";
     bfs(graph, 0);
+    cout << endl;
+
+    cout << "BFS Traversal (CSR): ";
+    bfs(CsrGraph<>::fromAdjacencyList(graph), 0);
+    cout << endl;
+
+    // Distances and parents instead of printing
+    BfsResult<uint32_t> small = parallelBfs(CsrGraph<>::fromAdjacencyList(graph), 0u);
+    cout << "Distances:";
+    for (uint32_t d : small.distance) cout << " " << d;
+    cout << endl << "Parents:  ";
+    for (uint32_t p : small.parent) cout << " " << p;
+    cout << endl;
+
+    // A low-diameter, skewed-degree graph (R-MAT, like a social network):
+    // 2^20 vertices, 16 edges per vertex, undirected
+    const int scale = 20;
+    const size_t n = size_t(1) << scale, m = 16 * n;
+    mt19937_64 rng(11);
+    uniform_real_distribution<double> coin(0, 1);
+    vector<pair<uint32_t, uint32_t>> edges(m);
+    for (auto& e : edges) {
+        uint32_t u = 0, v = 0;
+        for (int bit = 0; bit < scale; ++bit) {
+            double r = coin(rng);
+            int quadrant = r < 0.57 ? 0 : r < 0.76 ? 1 : r < 0.95 ? 2 : 3;
+            u = 2 * u + (quadrant >> 1);
+            v = 2 * v + (quadrant & 1);
+        }
+        e = {u, v};
+    }
+    CsrBuildOptions undirected;
+    undirected.symmetrize = true;
+    undirected.dropSelfLoops = true;
+    CsrGraph<> social = CsrGraph<>::fromEdges(n, edges, undirected);
+    uint32_t source = 0;
+    while (social.degree(source) == 0) ++source;
+
+    auto run = [&](const char* name, const BfsOptions& options) {
+        auto start = chrono::steady_clock::now();
+        BfsResult<uint32_t> r = parallelBfs(social, source, options);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        size_t reached = count_if(r.distance.begin(), r.distance.end(), [](uint32_t d) { return d != kBfsUnreached<uint32_t>; });
+        cout << "  " << name << ms << " ms, " << r.topDownSteps << " top-down + " << r.bottomUpSteps
+             << " bottom-up steps, " << reached << " reached" << endl;
+        return r.distance;
+    };
+    BfsOptions topDownOnly;
+    topDownOnly.directionOptimizing = false;
+    cout << "BFS on " << n << " vertices, " << social.numEdges() << " directed edges:" << endl;
+    vector<uint32_t> a = run("top-down only:        ", topDownOnly);
+    vector<uint32_t> b = run("direction-optimizing: ", BfsOptions());
+    cout << "Distances match: " << (a == b ? "yes" : "no") << endl;
     return 0;
 }
 
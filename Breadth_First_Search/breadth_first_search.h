@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Parallel, level-synchronous, direction-optimizing BFS (Beamer et al.) on a
+// CsrGraph.
+//
+// Top-down steps expand the frontier: every frontier vertex claims its
+// unvisited neighbors with an atomic fetch_or on a visited bitmap. That is
+// cheap while the frontier is small. On low-diameter graphs, though, the
+// frontier soon holds a large part of the graph and most edges lead to
+// vertices that are already visited. Bottom-up steps then turn the search
+// around: every unvisited vertex scans its in-neighbors and stops at the first
+// one in the frontier bitmap, which skips most of the remaining edges.
+//
+// The search switches to bottom-up when the edges leaving the frontier exceed
+// the unexplored edges / alpha, and back to top-down when the frontier shrinks
+// below n / beta vertices.
+//
+// The result is a distance (level) and parent array; the parent of the source
+// is the source itself, and unreached vertices have kBfsUnreached in both.
+// Which of several same-level parents a vertex gets depends on scheduling.
+
+template <typename Id>
+constexpr Id kBfsUnreached = std::numeric_limits<Id>::max();
+
+struct BfsOptions {
+    bool directionOptimizing = true; // false: top-down steps only
+    double alpha = 15.0;
+    double beta = 18.0;
+};
+
+template <typename Id>
+struct BfsResult {
+    std::vector<Id> distance;
+    std::vector<Id> parent;
+    size_t topDownSteps = 0;
+    size_t bottomUpSteps = 0;
+};
+
+namespace bfs_detail {
+
+constexpr size_t kTopDownGrain = 256;    // Frontier vertices per task
+constexpr size_t kBottomUpGrainWords = 64; // Bitmap words (4096 vertices) per task
+
+class AtomicBitmap {
+public:
+    explicit AtomicBitmap(size_t bits) : count((bits + 63) / 64), words(new std::atomic<uint64_t>[count]) { clear(); }
+
+    size_t wordCount() const { return count; }
+
+    void clear() {
+        for (size_t w = 0; w < count; ++w) words[w].store(0, std::memory_order_relaxed);
+    }
+
+    bool test(size_t i) const {
+        return (words[i / 64].load(std::memory_order_relaxed) >> (i % 64)) & 1;
+    }
+
+    // Sets bit i; returns true if this call changed it.
+    bool claim(size_t i) {
+        uint64_t bit = uint64_t(1) << (i % 64);
+        if (words[i / 64].load(std::memory_order_relaxed) & bit) return false;
+        return !(words[i / 64].fetch_or(bit, std::memory_order_relaxed) & bit);
+    }
+
+    uint64_t word(size_t w) const { return words[w].load(std::memory_order_relaxed); }
+    void setWord(size_t w, uint64_t value) { words[w].store(value, std::memory_order_relaxed); }
+
+private:
+    size_t count;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+};
+
+// Top-down step: expands the frontier queue into next. Returns the sum of the
+// out-degrees of the new frontier.
+template <typename Id, typename Weight>
+uint64_t topDownStep(const CsrGraph<Id, Weight>& graph, const std::vector<Id>& frontier, std::vector<Id>& next,
+                     AtomicBitmap& visited, BfsResult<Id>& result, Id level, ThreadPool& pool) {
+    size_t chunks = (frontier.size() + kTopDownGrain - 1) / kTopDownGrain;
+    std::vector<std::vector<Id>> found(chunks);
+    std::vector<uint64_t> degrees(chunks, 0);
+    pool.parallelFor(chunks, [&](size_t c) {
+        size_t end = std::min(frontier.size(), (c + 1) * kTopDownGrain);
+        for (size_t i = c * kTopDownGrain; i < end; ++i) {
+            Id u = frontier[i];
+            for (Id v : graph.neighbors(u)) {
+                if (!visited.claim(v)) continue;
+                result.parent[v] = u;
+                result.distance[v] = level + 1;
+                found[c].push_back(v);
+                degrees[c] += graph.degree(v);
+            }
+        }
+    });
+    next.clear();
+    uint64_t degreeSum = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        next.insert(next.end(), found[c].begin(), found[c].end());
+        degreeSum += degrees[c];
+    }
+    return degreeSum;
+}
+
+// Bottom-up step: every unvisited vertex looks for a parent among its
+// in-neighbors in the frontier bitmap. Tasks own whole bitmap words, so the
+// visited and next bitmaps are updated without read-modify-write atomics.
+// Returns the number of vertices found and the sum of their out-degrees.
+template <typename Id, typename Weight>
+std::pair<size_t, uint64_t> bottomUpStep(const CsrGraph<Id, Weight>& graph, const CsrGraph<Id, Weight>& inGraph,
+                                         const AtomicBitmap& frontier, AtomicBitmap& next, AtomicBitmap& visited,
+                                         BfsResult<Id>& result, Id level, ThreadPool& pool) {
+    size_t n = graph.numVertices();
+    size_t blocks = (visited.wordCount() + kBottomUpGrainWords - 1) / kBottomUpGrainWords;
+    std::vector<size_t> counts(blocks, 0);
+    std::vector<uint64_t> degrees(blocks, 0);
+    pool.parallelFor(blocks, [&](size_t b) {
+        size_t endWord = std::min(visited.wordCount(), (b + 1) * kBottomUpGrainWords);
+        for (size_t w = b * kBottomUpGrainWords; w < endWord; ++w) {
+            uint64_t seen = visited.word(w);
+            uint64_t added = 0;
+            for (uint64_t open = ~seen; open != 0; open &= open - 1) {
+                size_t v = w * 64 + static_cast<size_t>(__builtin_ctzll(open));
+                if (v >= n) break;
+                for (Id u : inGraph.neighbors(static_cast<Id>(v))) {
+                    if (!frontier.test(u)) continue;
+                    result.parent[v] = u;
+                    result.distance[v] = level + 1;
+                    added |= uint64_t(1) << (v % 64);
+                    ++counts[b];
+                    degrees[b] += graph.degree(static_cast<Id>(v));
+                    break;
+                }
+            }
+            next.setWord(w, added);
+            if (added) visited.setWord(w, seen | added);
+        }
+    }, 1);
+    std::pair<size_t, uint64_t> total{0, 0};
+    for (size_t b = 0; b < blocks; ++b) {
+        total.first += counts[b];
+        total.second += degrees[b];
+    }
+    return total;
+}
+
+} // namespace bfs_detail
+
+// BFS from source over a directed graph; inGraph must be graph.reversed()
+// (the in-edges), which bottom-up steps scan.
+template <typename Id, typename Weight>
+BfsResult<Id> parallelBfs(const CsrGraph<Id, Weight>& graph, const CsrGraph<Id, Weight>& inGraph, Id source,
+                          const BfsOptions& options = {}, ThreadPool& pool = defaultThreadPool()) {
+    using namespace bfs_detail;
+    size_t n = graph.numVertices();
+    BfsResult<Id> result;
+    result.distance.assign(n, kBfsUnreached<Id>);
+    result.parent.assign(n, kBfsUnreached<Id>);
+    if (source >= n) return result;
+
+    AtomicBitmap visited(n), frontierBits(n), nextBits(n);
+    std::vector<Id> frontier{source}, next;
+    visited.claim(source);
+    result.distance[source] = 0;
+    result.parent[source] = source;
+
+    uint64_t frontierEdges = graph.degree(source);
+    uint64_t unexploredEdges = graph.numEdges() - frontierEdges;
+    size_t frontierSize = 1;
+    bool bottomUp = false;
+
+    for (Id level = 0; frontierSize > 0; ++level) {
+        if (options.directionOptimizing) {
+            if (!bottomUp && static_cast<double>(frontierEdges) > static_cast<double>(unexploredEdges) / options.alpha) {
+                // Queue to bitmap
+                bottomUp = true;
+                frontierBits.clear();
+                for (Id v : frontier) frontierBits.claim(v);
+            } else if (bottomUp && static_cast<double>(frontierSize) < static_cast<double>(n) / options.beta) {
+                // Bitmap to queue
+                bottomUp = false;
+                frontier.clear();
+                for (size_t w = 0; w < frontierBits.wordCount(); ++w) {
+                    for (uint64_t bits = frontierBits.word(w); bits != 0; bits &= bits - 1) {
+                        frontier.push_back(static_cast<Id>(w * 64 + __builtin_ctzll(bits)));
+                    }
+                }
+            }
+        }
+        if (bottomUp) {
+            auto [found, degrees] = bottomUpStep(graph, inGraph, frontierBits, nextBits, visited, result, level, pool);
+            std::swap(frontierBits, nextBits);
+            frontierSize = found;
+            frontierEdges = degrees;
+            ++result.bottomUpSteps;
+        } else {
+            frontierEdges = topDownStep(graph, frontier, next, visited, result, level, pool);
+            std::swap(frontier, next);
+            frontierSize = frontier.size();
+            ++result.topDownSteps;
+        }
+        unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+    }
+    return result;
+}
+
+// BFS over an undirected graph (every edge stored in both directions), which
+// is its own in-edge graph.
+template <typename Id, typename Weight>
+BfsResult<Id> parallelBfs(const CsrGraph<Id, Weight>& graph, Id source, const BfsOptions& options = {},
+                          ThreadPool& pool = defaultThreadPool()) {
+    return parallelBfs(graph, graph, source, options, pool);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+
+// Generic bubble sort, stable. Stops after the first pass without a swap, so
+// already sorted input costs a single pass.
+template <typename RandomIt, typename Compare = std::less<>>
+void bubbleSort(RandomIt first, RandomIt last, Compare cmp = Compare()) {
+    for (RandomIt end = last; end - first > 1; --end) {
+        bool swapped = false;
+        for (RandomIt j = first; j + 1 < end; ++j) {
+            if (cmp(*(j + 1), *j)) {
+                std::iter_swap(j, j + 1);
+                swapped = true;
+            }
+        }
+        if (!swapped) return;
+    }
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include "csr_graph.h"
+using namespace std;
+
+int main() {
+    // The adjacency list used by the BFS and DFS examples
+    vector<vector<int>> lists = {
+        {1, 2},  // Node 0 is connected to 1 and 2
+        {0, 3},  // Node 1 is connected to 0 and 3
+        {0, 4},  // Node 2 is connected to 0 and 4
+        {1},     // Node 3 is connected to 1
+        {2}      // Node 4 is connected to 2
+    };
+    CsrGraph<> small = CsrGraph<>::fromAdjacencyList(lists);
+    cout << "offsets:";
+    for (size_t v = 0; v <= small.numVertices(); ++v) cout << " " << small.offsets()[v];
+    cout << endl << "targets:";
+    for (uint64_t e = 0; e < small.numEdges(); ++e) cout << " " << small.target(e);
+    cout << endl;
+    for (uint32_t v = 0; v < small.numVertices(); ++v) {
+        cout << "Node " << v << ":";
+        for (uint32_t u : small.neighbors(v)) cout << " " << u;
+        cout << endl;
+    }
+
+    // A random weighted graph: convert, save, map
+    const size_t n = size_t(1) << 21, m = size_t(1) << 24;
+    mt19937_64 rng(3);
+    vector<CsrEdge<uint32_t, int32_t>> edges(m);
+    for (auto& e : edges) e = {uint32_t(rng() % n), uint32_t(rng() % n), int32_t(rng() % 1000)};
+
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    auto start = chrono::steady_clock::now();
+    CsrGraph<> graph = CsrGraph<>::fromEdges(n, edges);
+    double buildMs = since(start);
+    const string path = "csr_graph_demo.bin";
+    start = chrono::steady_clock::now();
+    graph.save(path);
+    double saveMs = since(start);
+    start = chrono::steady_clock::now();
+    CsrGraph<> mapped = CsrGraph<>::map(path);
+    double mapMs = since(start);
+    cout << n << " vertices, " << m << " edges: built in " << buildMs << " ms, saved in " << saveMs
+         << " ms, mapped in " << mapMs << " ms" << endl;
+
+    // Sum of all edge weights, on the CSR arrays and on the nested vectors
+    // the classic examples use
+    vector<vector<pair<int, int>>> nested(n);
+    for (const auto& e : edges) nested[e.source].push_back({int(e.target), e.weight});
+    auto time = [&](const char* name, auto&& sum) {
+        start = chrono::steady_clock::now();
+        int64_t total = sum();
+        cout << "  " << name << since(start) << " ms (sum " << total << ")" << endl;
+    };
+    cout << "Scanning every edge:" << endl;
+    time("vector<vector<pair>>: ", [&] {
+        int64_t total = 0;
+        for (const auto& list : nested) {
+            for (const auto& [v, w] : list) total += w;
+        }
+        return total;
+    });
+    time("CSR:                  ", [&] {
+        int64_t total = 0;
+        for (uint32_t v = 0; v < n; ++v) {
+            for (uint64_t e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) total += graph.weight(e);
+        }
+        return total;
+    });
+    time("CSR, mapped file:     ", [&] {
+        int64_t total = 0;
+        mapped.forEachEdge([&](uint32_t, uint32_t, int32_t w) { total += w; });
+        return total;
+    });
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Thread_Pool/thread_pool.h"
+
+// Compressed sparse row (CSR) graph shared by the graph algorithms in this
+// repository.
+//
+// The out-edges of vertex v are edges offsets[v] .. offsets[v + 1] - 1: their
+// targets are in one array, and their weights (if any) in a parallel one. A
+// traversal reads the neighbors of a vertex as one contiguous run instead of
+// chasing a pointer per vertex, and the whole graph is three allocations of
+// 8 bytes per vertex plus sizeof(Id) (+ sizeof(Weight)) per edge.
+//
+// Vertex ids are 32- or 64-bit unsigned integers; edge offsets are always
+// 64-bit, so a graph can have more than 4 billion edges with 32-bit ids.
+// Unweighted graphs report weight 1 for every edge.
+//
+// The arrays are immutable once built. They are either owned (built in memory)
+// or mapped straight from a file written by save(); copies of a graph share
+// them.
+
+template <typename Id, typename Weight>
+struct CsrEdge {
+    Id source;
+    Id target;
+    Weight weight;
+};
+
+struct CsrBuildOptions {
+    bool symmetrize = false;    // Also add v -> u for every edge u -> v (undirected input)
+    bool dropSelfLoops = false;
+    bool sortNeighbors = true;  // Neighbors of every vertex in increasing id order
+};
+
+namespace csr_graph_detail {
+
+constexpr char kMagic[8] = {'C', 'S', 'R', 'G', 'R', 'P', 'H', '1'};
+constexpr uint64_t kSectionAlign = 4096; // Arrays start on page boundaries in the file
+
+struct Header {
+    char magic[8];
+    uint64_t idSize;
+    uint64_t weightSize;    // 0 for an unweighted graph
+    uint64_t weightIsFloat;
+    uint64_t vertices;
+    uint64_t edges;
+    uint64_t offsetsAt;     // Byte positions of the three arrays
+    uint64_t targetsAt;
+    uint64_t weightsAt;
+};
+
+inline uint64_t roundUp(uint64_t x, uint64_t to) {
+    return (x + to - 1) / to * to;
+}
+
+// True if count elements of elementSize bytes starting at byte `at` lie within
+// size bytes. Divides instead of multiplying, so the values of a corrupt
+// header cannot overflow the check.
+inline bool sectionFits(uint64_t at, uint64_t count, uint64_t elementSize, uint64_t size) {
+    return at <= size && (elementSize == 0 || count <= (size - at) / elementSize);
+}
+
+// Read-only memory mapping of a whole file.
+class Mapping {
+public:
+    explicit Mapping(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("CSR graph: cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("CSR graph: cannot stat " + path);
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        void* p = bytes ? ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+        ::close(fd); // The mapping keeps the file open
+        if (p == MAP_FAILED) throw std::runtime_error("CSR graph: cannot map " + path);
+        base = static_cast<const char*>(p);
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping() {
+        if (base) ::munmap(const_cast<char*>(base), bytes);
+    }
+
+    const char* data() const { return base; }
+    size_t size() const { return bytes; }
+
+private:
+    const char* base = nullptr;
+    size_t bytes = 0;
+};
+
+template <typename Id, typename Weight>
+struct OwnedArrays {
+    std::vector<uint64_t> offsets;
+    std::vector<Id> targets;
+    std::vector<Weight> weights;
+};
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { if (f) std::fclose(f); }
+};
+
+inline void writeAt(std::FILE* f, uint64_t at, const void* src, size_t bytes) {
+    static const char zeros[4096] = {};
+    long long pos = std::ftell(f);
+    for (uint64_t gap = at - static_cast<uint64_t>(pos); gap > 0;) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(gap, sizeof(zeros)));
+        if (std::fwrite(zeros, 1, chunk, f) != chunk) throw std::runtime_error("CSR graph: write failed");
+        gap -= chunk;
+    }
+    if (bytes && std::fwrite(src, 1, bytes, f) != bytes) throw std::runtime_error("CSR graph: write failed");
+}
+
+} // namespace csr_graph_detail
+
+template <typename Id = uint32_t, typename Weight = int32_t>
+class CsrGraph {
+    static_assert(std::is_unsigned<Id>::value && (sizeof(Id) == 4 || sizeof(Id) == 8), "32- or 64-bit unsigned ids");
+    static_assert(std::is_arithmetic<Weight>::value, "arithmetic weights");
+
+public:
+    using VertexId = Id;
+    using WeightType = Weight;
+    using Edge = CsrEdge<Id, Weight>;
+
+    // The out-neighbors of one vertex, as a contiguous range.
+    struct Neighbors {
+        const Id* first;
+        const Id* last;
+        const Id* begin() const { return first; }
+        const Id* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        Id operator[](size_t i) const { return first[i]; }
+    };
+
+    CsrGraph() = default;
+
+    // Takes ready-made CSR arrays: offsets has numVertices + 1 entries, and
+    // weights is empty or parallel to targets. Throws std::invalid_argument if
+    // they are inconsistent.
+    CsrGraph(std::vector<uint64_t> offsets, std::vector<Id> targets, std::vector<Weight> weights = {}) {
+        if (offsets.empty() || offsets.front() != 0 || offsets.back() != targets.size() ||
+            !std::is_sorted(offsets.begin(), offsets.end())) {
+            throw std::invalid_argument("CSR graph: offsets do not describe the target array");
+        }
+        if (!weights.empty() && weights.size() != targets.size()) {
+            throw std::invalid_argument("CSR graph: weights are not parallel to targets");
+        }
+        size_t n = offsets.size() - 1;
+        for (Id t : targets) {
+            if (t >= n) throw std::invalid_argument("CSR graph: target out of range");
+        }
+        auto arrays = std::make_shared<csr_graph_detail::OwnedArrays<Id, Weight>>();
+        arrays->offsets = std::move(offsets);
+        arrays->targets = std::move(targets);
+        bool withWeights = !weights.empty();
+        arrays->weights = std::move(weights);
+        adopt(arrays, withWeights);
+    }
+
+    // Builds the graph from a weighted edge list by counting sort on the
+    // source. Throws std::invalid_argument for ids >= numVertices.
+    static CsrGraph fromEdges(size_t numVertices, const std::vector<Edge>& edges, const CsrBuildOptions& options = {},
+                              ThreadPool& pool = defaultThreadPool()) {
+        return build(numVertices, edges.size(), options, pool, true, [&](size_t i) {
+            return std::make_pair(edges[i].source, edges[i].target);
+        }, [&](size_t i) { return edges[i].weight; });
+    }
+
+    // Unweighted edge list of (source, target) pairs.
+    static CsrGraph fromEdges(size_t numVertices, const std::vector<std::pair<Id, Id>>& edges,
+                              const CsrBuildOptions& options = {}, ThreadPool& pool = defaultThreadPool()) {
+        return build(numVertices, edges.size(), options, pool, false, [&](size_t i) { return edges[i]; },
+                     [](size_t) { return Weight(1); });
+    }
+
+    // Converters from the representations of the classic examples:
+    // vector<vector<int>> adjacency lists, vector<vector<pair<int, int>>>
+    // (neighbor, weight) lists, and dense matrices in which noEdge (and the
+    // diagonal) means "no edge". Neighbor order is kept.
+    template <typename Int>
+    static CsrGraph fromAdjacencyList(const std::vector<std::vector<Int>>& lists) {
+        std::vector<std::pair<Id, Id>> edges;
+        for (size_t u = 0; u < lists.size(); ++u) {
+            for (Int v : lists[u]) edges.emplace_back(static_cast<Id>(u), static_cast<Id>(v));
+        }
+        return fromEdges(lists.size(), edges, keepOrder());
+    }
+
+    template <typename Int, typename W>
+    static CsrGraph fromAdjacencyList(const std::vector<std::vector<std::pair<Int, W>>>& lists) {
+        std::vector<Edge> edges;
+        for (size_t u = 0; u < lists.size(); ++u) {
+            for (const auto& [v, w] : lists[u]) edges.push_back({static_cast<Id>(u), static_cast<Id>(v), static_cast<Weight>(w)});
+        }
+        return fromEdges(lists.size(), edges, keepOrder());
+    }
+
+    template <typename W>
+    static CsrGraph fromAdjacencyMatrix(const std::vector<std::vector<W>>& matrix, W noEdge) {
+        std::vector<Edge> edges;
+        for (size_t u = 0; u < matrix.size(); ++u) {
+            for (size_t v = 0; v < matrix[u].size(); ++v) {
+                if (u != v && matrix[u][v] != noEdge) {
+                    edges.push_back({static_cast<Id>(u), static_cast<Id>(v), static_cast<Weight>(matrix[u][v])});
+                }
+            }
+        }
+        return fromEdges(matrix.size(), edges, keepOrder());
+    }
+
+    // Writes the graph in the binary format that map() reads: a header, then
+    // the offsets, targets and weights, each starting on a page boundary.
+    void save(const std::string& path) const {
+        using namespace csr_graph_detail;
+        Header h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.idSize = sizeof(Id);
+        h.weightSize = weighted() ? sizeof(Weight) : 0;
+        h.weightIsFloat = std::is_floating_point<Weight>::value;
+        h.vertices = n;
+        h.edges = m;
+        h.offsetsAt = roundUp(sizeof(Header), kSectionAlign);
+        h.targetsAt = roundUp(h.offsetsAt + (n + 1) * sizeof(uint64_t), kSectionAlign);
+        h.weightsAt = weighted() ? roundUp(h.targetsAt + m * sizeof(Id), kSectionAlign) : 0;
+
+        std::unique_ptr<std::FILE, FileCloser> f(std::fopen(path.c_str(), "wb"));
+        if (!f) throw std::runtime_error("CSR graph: cannot create " + path);
+        writeAt(f.get(), 0, &h, sizeof(h));
+        writeAt(f.get(), h.offsetsAt, offsetData, (n + 1) * sizeof(uint64_t));
+        writeAt(f.get(), h.targetsAt, targetData, m * sizeof(Id));
+        if (weighted()) writeAt(f.get(), h.weightsAt, weightData, m * sizeof(Weight));
+        if (std::fflush(f.get()) != 0) throw std::runtime_error("CSR graph: write failed");
+    }
+
+    // Maps a file written by save() without copying or parsing the arrays:
+    // the graph is usable immediately, and pages are read on first access.
+    // Only the header and the array bounds are checked.
+    static CsrGraph map(const std::string& path) {
+        using namespace csr_graph_detail;
+        auto mapping = std::make_shared<Mapping>(path);
+        Header h;
+        if (mapping->size() < sizeof(Header)) throw std::runtime_error("CSR graph: " + path + " is too short");
+        std::memcpy(&h, mapping->data(), sizeof(h));
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) throw std::runtime_error("CSR graph: " + path + " is not a CSR graph");
+        if (h.idSize != sizeof(Id)) throw std::runtime_error("CSR graph: vertex id size does not match");
+        if (h.weightSize != 0 && (h.weightSize != sizeof(Weight) ||
+                                  h.weightIsFloat != static_cast<uint64_t>(std::is_floating_point<Weight>::value))) {
+            throw std::runtime_error("CSR graph: weight type does not match");
+        }
+        uint64_t size = mapping->size();
+        bool fits = h.vertices < UINT64_MAX && sectionFits(h.offsetsAt, h.vertices + 1, sizeof(uint64_t), size) &&
+                    sectionFits(h.targetsAt, h.edges, sizeof(Id), size) &&
+                    (!h.weightSize || sectionFits(h.weightsAt, h.edges, sizeof(Weight), size));
+        if (!fits || h.offsetsAt % kSectionAlign || h.targetsAt % kSectionAlign || h.weightsAt % kSectionAlign) {
+            throw std::runtime_error("CSR graph: " + path + " is truncated or corrupt");
+        }
+
+        CsrGraph g;
+        g.n = h.vertices;
+        g.m = h.edges;
+        g.offsetData = reinterpret_cast<const uint64_t*>(mapping->data() + h.offsetsAt);
+        g.targetData = reinterpret_cast<const Id*>(mapping->data() + h.targetsAt);
+        g.isWeighted = h.weightSize != 0;
+        g.weightData = g.isWeighted ? reinterpret_cast<const Weight*>(mapping->data() + h.weightsAt) : nullptr;
+        if (g.offsetData[0] != 0 || g.offsetData[g.n] != g.m) throw std::runtime_error("CSR graph: " + path + " is corrupt");
+        g.owner = std::move(mapping);
+        return g;
+    }
+
+    // The graph with every edge reversed (in-edges become out-edges).
+    // Neighbor lists come out sorted.
+    CsrGraph reversed() const {
+        auto arrays = std::make_shared<csr_graph_detail::OwnedArrays<Id, Weight>>();
+        arrays->offsets.assign(n + 1, 0);
+        for (uint64_t e = 0; e < m; ++e) ++arrays->offsets[targetData[e] + 1];
+        for (size_t v = 0; v < n; ++v) arrays->offsets[v + 1] += arrays->offsets[v];
+        arrays->targets.resize(m);
+        if (weighted()) arrays->weights.resize(m);
+        std::vector<uint64_t> cursor(arrays->offsets.begin(), arrays->offsets.end() - 1);
+        for (size_t u = 0; u < n; ++u) {
+            for (uint64_t e = offsetData[u]; e < offsetData[u + 1]; ++e) {
+                uint64_t slot = cursor[targetData[e]]++;
+                arrays->targets[slot] = static_cast<Id>(u);
+                if (weighted()) arrays->weights[slot] = weightData[e];
+            }
+        }
+        CsrGraph g;
+        g.adopt(arrays, weighted());
+        return g;
+    }
+
+    size_t numVertices() const { return n; }
+    uint64_t numEdges() const { return m; }
+    bool weighted() const { return isWeighted; }
+
+    uint64_t degree(Id v) const { return offsetData[v + 1] - offsetData[v]; }
+    Neighbors neighbors(Id v) const { return {targetData + offsetData[v], targetData + offsetData[v + 1]}; }
+
+    // Edge indices of v's out-edges are [edgeBegin(v), edgeEnd(v)).
+    uint64_t edgeBegin(Id v) const { return offsetData[v]; }
+    uint64_t edgeEnd(Id v) const { return offsetData[v + 1]; }
+    Id target(uint64_t e) const { return targetData[e]; }
+    Weight weight(uint64_t e) const { return isWeighted ? weightData[e] : Weight(1); }
+
+    // Raw arrays; weights() is only meaningful for a weighted graph.
+    const uint64_t* offsets() const { return offsetData; }
+    const Id* targets() const { return targetData; }
+    const Weight* weights() const { return weightData; }
+
+    // Calls fn(source, target, weight) for every edge, grouped by source.
+    template <typename Fn>
+    void forEachEdge(Fn&& fn) const {
+        for (size_t u = 0; u < n; ++u) {
+            for (uint64_t e = offsetData[u]; e < offsetData[u + 1]; ++e) fn(static_cast<Id>(u), targetData[e], weight(e));
+        }
+    }
+
+private:
+    static constexpr size_t kPrefetchDistance = 16;
+
+    static CsrBuildOptions keepOrder() {
+        CsrBuildOptions options;
+        options.sortNeighbors = false;
+        return options;
+    }
+
+    void adopt(const std::shared_ptr<csr_graph_detail::OwnedArrays<Id, Weight>>& arrays, bool withWeights) {
+        n = arrays->offsets.size() - 1;
+        m = arrays->targets.size();
+        offsetData = arrays->offsets.data();
+        targetData = arrays->targets.data();
+        weightData = arrays->weights.data();
+        isWeighted = withWeights;
+        owner = arrays;
+    }
+
+    // Counting sort of the edges by source: count the out-degrees, turn them
+    // into offsets, scatter. Every edge lands on a random vertex, so both
+    // passes prefetch a few edges ahead. Then the neighbor lists are sorted in
+    // parallel.
+    template <typename EndpointsOf, typename WeightOf>
+    static CsrGraph build(size_t numVertices, size_t count, const CsrBuildOptions& options, ThreadPool& pool,
+                          bool withWeights, EndpointsOf endpointsOf, WeightOf weightOf) {
+        if (numVertices > static_cast<size_t>(static_cast<Id>(~Id(0)))) {
+            throw std::invalid_argument("CSR graph: too many vertices for the id type");
+        }
+        auto keep = [&](Id u, Id v) { return !(options.dropSelfLoops && u == v); };
+        auto arrays = std::make_shared<csr_graph_detail::OwnedArrays<Id, Weight>>();
+        std::vector<uint64_t>& offsets = arrays->offsets;
+        offsets.assign(numVertices + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            if (i + kPrefetchDistance < count) __builtin_prefetch(offsets.data() + endpointsOf(i + kPrefetchDistance).first);
+            auto [u, v] = endpointsOf(i);
+            if (u >= numVertices || v >= numVertices) throw std::invalid_argument("CSR graph: edge endpoint out of range");
+            if (!keep(u, v)) continue;
+            ++offsets[u + 1];
+            if (options.symmetrize && u != v) ++offsets[v + 1];
+        }
+        for (size_t v = 0; v < numVertices; ++v) offsets[v + 1] += offsets[v];
+
+        std::vector<Id>& targets = arrays->targets;
+        std::vector<Weight>& weights = arrays->weights;
+        targets.resize(offsets[numVertices]);
+        if (withWeights) weights.resize(targets.size());
+        std::vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+        auto place = [&](Id u, Id v, size_t i) {
+            uint64_t slot = cursor[u]++;
+            targets[slot] = v;
+            if (withWeights) weights[slot] = weightOf(i);
+        };
+        for (size_t i = 0; i < count; ++i) {
+            // Two-stage prefetch: the cursor of a later edge, then the slot it
+            // points to.
+            if (i + 2 * kPrefetchDistance < count) __builtin_prefetch(cursor.data() + endpointsOf(i + 2 * kPrefetchDistance).first);
+            if (i + kPrefetchDistance < count) {
+                uint64_t slot = cursor[endpointsOf(i + kPrefetchDistance).first];
+                __builtin_prefetch(targets.data() + slot, 1);
+                if (withWeights) __builtin_prefetch(weights.data() + slot, 1);
+            }
+            auto [u, v] = endpointsOf(i);
+            if (!keep(u, v)) continue;
+            place(u, v, i);
+            if (options.symmetrize && u != v) place(v, u, i);
+        }
+        cursor = std::vector<uint64_t>();
+
+        if (options.sortNeighbors) {
+            pool.parallelFor(numVertices, [&](size_t v) {
+                uint64_t first = offsets[v], last = offsets[v + 1];
+                if (last - first < 2) return;
+                if (!withWeights) {
+                    std::sort(targets.begin() + first, targets.begin() + last);
+                    return;
+                }
+                thread_local std::vector<std::pair<Id, Weight>> scratch;
+                scratch.clear();
+                for (uint64_t e = first; e < last; ++e) scratch.emplace_back(targets[e], weights[e]);
+                std::sort(scratch.begin(), scratch.end());
+                for (uint64_t e = first; e < last; ++e) {
+                    targets[e] = scratch[e - first].first;
+                    weights[e] = scratch[e - first].second;
+                }
+            }, 1024);
+        }
+        CsrGraph g;
+        g.adopt(arrays, withWeights);
+        return g;
+    }
+
+    std::shared_ptr<const void> owner;
+    size_t n = 0;
+    uint64_t m = 0;
+    const uint64_t* offsetData = nullptr;
+    const Id* targetData = nullptr;
+    const Weight* weightData = nullptr;
+    bool isWeighted = false;
+};
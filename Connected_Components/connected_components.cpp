@@ -0,0 +1,60 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "connected_components.h"
+using namespace std;
+
+size_t countComponents(const vector<uint32_t>& label) {
+    size_t count = 0;
+    for (size_t v = 0; v < label.size(); ++v) count += label[v] == v;
+    return count;
+}
+
+int main() {
+    // Two triangles and an isolated vertex
+    vector<pair<uint32_t, uint32_t>> small = {{0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}};
+    CsrBuildOptions undirected;
+    undirected.symmetrize = true;
+    vector<uint32_t> label = connectedComponents(CsrGraph<>::fromEdges(7, small, undirected));
+    cout << "Component labels:";
+    for (uint32_t l : label) cout << " " << l;
+    cout << endl;
+
+    // A random graph: 2^21 vertices, 2^24 undirected edges (average degree 16)
+    const size_t n = size_t(1) << 21, m = size_t(1) << 24;
+    mt19937_64 rng(37);
+    vector<pair<uint32_t, uint32_t>> edges(m);
+    for (auto& e : edges) e = {uint32_t(rng() % n), uint32_t(rng() % n)};
+    CsrGraph<> graph = CsrGraph<>::fromEdges(n, edges, undirected);
+    cout << "Random graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " directed edges" << endl;
+
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    auto start = chrono::steady_clock::now();
+    UnionFind sequential(n);
+    for (const auto& [u, v] : edges) sequential.unionSets(u, v);
+    size_t expected = 0;
+    for (size_t v = 0; v < n; ++v) expected += sequential.find(v) == int(v);
+    cout << "  UnionFind over all edges: " << since(start) << " ms, components: " << expected << endl;
+
+    for (size_t threads : {1, 2, 4}) {
+        ThreadPool pool(threads);
+        start = chrono::steady_clock::now();
+        ConcurrentUnionFind<uint32_t> sets(n, pool);
+        sets.uniteBatch(edges, pool);
+        vector<uint32_t> all = sets.labels(pool);
+        double batchMs = since(start);
+
+        start = chrono::steady_clock::now();
+        vector<uint32_t> afforest = connectedComponents(graph, AfforestOptions(), pool);
+        double afforestMs = since(start);
+        cout << "  " << threads << " thread" << (threads > 1 ? "s" : " ") << ": uniteBatch " << batchMs
+             << " ms, Afforest " << afforestMs << " ms, components: " << countComponents(afforest)
+             << ", same labels: " << (afforest == all ? "yes" : "no") << endl;
+    }
+    return 0;
+}
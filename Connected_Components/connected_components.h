@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Thread_Pool/thread_pool.h"
+#include "../Union_Find_Algorithm/union_find_algorithm.h"
+
+// Parallel connected components of an undirected CsrGraph with Afforest
+// (Sutton, Ben-Nun and Barak), on top of ConcurrentUnionFind.
+//
+// Uniting the ends of every edge works, but most of those edges end up
+// inside one giant component, where each union only confirms what is
+// already known. Afforest avoids them:
+// 1. Neighbor sampling: every vertex is united with its first few neighbors
+//    only. This already links almost all of a giant component, because it
+//    is a random sample of a well-connected graph.
+// 2. Every few steps the sets are flattened, so finds are one step.
+// 3. The largest set is found from a sample of vertices. Only vertices that
+//    are not in it unite with their remaining neighbors: an edge from the
+//    largest set to another vertex is also an edge of that other vertex, so
+//    it is still seen from there.
+//
+// Labels are the smallest vertex of each component, so they do not depend on
+// the number of threads.
+
+struct AfforestOptions {
+    size_t neighborRounds = 2; // Neighbors per vertex united before sampling
+    size_t samples = 1024;     // Vertices sampled to find the largest component
+};
+
+// Component label of every vertex. The graph must store each edge in both
+// directions.
+template <typename Id, typename Weight>
+std::vector<Id> connectedComponents(const CsrGraph<Id, Weight>& graph, const AfforestOptions& options = {},
+                                    ThreadPool& pool = defaultThreadPool()) {
+    size_t n = graph.numVertices();
+    ConcurrentUnionFind<Id> sets(n, pool);
+    for (size_t r = 0; r < options.neighborRounds; ++r) {
+        pool.parallelFor(n, [&](size_t u) {
+            Id v = static_cast<Id>(u);
+            if (graph.degree(v) > r) sets.unite(v, graph.target(graph.edgeBegin(v) + r));
+        }, 4096);
+        sets.flatten(pool);
+    }
+    if (n == 0) return {};
+
+    std::mt19937_64 rng(n);
+    std::unordered_map<Id, size_t> count;
+    Id largest = 0;
+    for (size_t i = 0; i < options.samples; ++i) {
+        Id root = sets.find(static_cast<Id>(rng() % n));
+        size_t seen = ++count[root];
+        if (seen > count[largest]) largest = root;
+    }
+
+    pool.parallelFor(n, [&](size_t u) {
+        Id v = static_cast<Id>(u);
+        if (sets.find(v) == largest) return;
+        for (uint64_t e = graph.edgeBegin(v) + options.neighborRounds; e < graph.edgeEnd(v); ++e) {
+            sets.unite(v, graph.target(e));
+        }
+    }, 1024);
+    return sets.labels(pool);
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "delta_stepping.h"
+using namespace std;
+
+int main() {
+    // The example graph of the Dijkstra module
+    vector<vector<pair<int, int>>> lists = {
+        {{1, 2}, {2, 4}},  // Node 0 -> 1 (weight 2), 0 -> 2 (weight 4)
+        {{2, 1}, {3, 7}},  // Node 1 -> 2 (weight 1), 1 -> 3 (weight 7)
+        {{3, 3}},          // Node 2 -> 3 (weight 3)
+        {}                 // Node 3 has no outgoing edges
+    };
+    vector<int64_t> small = deltaStepping(CsrGraph<>::fromAdjacencyList(lists), 0u);
+    cout << "Shortest distances from node 0:";
+    for (int64_t d : small) cout << " " << d;
+    cout << endl;
+
+    // A random graph: 2^21 vertices, 2^24 edges, weights 1..1000
+    const size_t n = size_t(1) << 21, m = size_t(1) << 24;
+    mt19937_64 rng(23);
+    vector<CsrEdge<uint32_t, int32_t>> edges(m);
+    for (auto& e : edges) e = {uint32_t(rng() % n), uint32_t(rng() % n), int32_t(1 + rng() % 1000)};
+    CsrGraph<> graph = CsrGraph<>::fromEdges(n, edges);
+    edges = {};
+    cout << "Random graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " edges" << endl;
+
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    auto start = chrono::steady_clock::now();
+    vector<int64_t> expected = dijkstra(graph, 0u).distance;
+    cout << "  dijkstra (4-ary heap):          " << since(start) << " ms" << endl;
+
+    for (double delta : {0.0, 20.0}) {
+        DeltaSteppingOptions options;
+        options.delta = delta;
+        for (size_t threads : {1, 2, 4}) {
+            ThreadPool pool(threads);
+            start = chrono::steady_clock::now();
+            vector<int64_t> found = deltaStepping(graph, 0u, options, pool);
+            double ms = since(start);
+            cout << "  delta-stepping, delta " << (delta == 0 ? "auto" : to_string(int(delta))) << ", " << threads
+                 << " thread" << (threads > 1 ? "s: " : ":  ") << ms << " ms, same as dijkstra: "
+                 << (found == expected ? "yes" : "no") << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Parallel delta-stepping single-source shortest paths (Meyer and Sanders) on
+// a CsrGraph with non-negative weights.
+//
+// Vertices are kept in buckets of width delta by tentative distance: bucket i
+// holds distances in [i * delta, (i + 1) * delta). Buckets are processed in
+// order, and all vertices of the current bucket are processed in parallel:
+// - Light phase: relax the light edges (weight < delta) of every vertex in the
+//   bucket. A relaxation can put a vertex back into the same bucket, so the
+//   phase repeats until the bucket stays empty. Every vertex that passed
+//   through the bucket is remembered.
+// - Heavy phase: relax the heavy edges (weight >= delta) of the remembered
+//   vertices once. Their distances are final now, and heavy edges only reach
+//   later buckets.
+//
+// A relaxation is an atomic compare-and-swap min on the target's distance; the
+// thread whose update succeeds appends the target to its own bins. With delta
+// near 0 this is Dijkstra, with delta at infinity Bellman-Ford; in between,
+// each bucket has enough vertices to share between threads while few are
+// relaxed more than once.
+//
+// The distances are exactly those of dijkstra(); only the order of work is
+// different.
+
+struct DeltaSteppingOptions {
+    double delta = 0; // Bucket width; 0 picks maxWeight / average out-degree
+};
+
+namespace delta_stepping_detail {
+
+constexpr size_t kChunk = 64; // Frontier vertices claimed at a time
+
+template <typename Distance>
+bool atomicMin(std::atomic<Distance>& target, Distance value) {
+    Distance current = target.load(std::memory_order_relaxed);
+    while (value < current) {
+        if (target.compare_exchange_weak(current, value, std::memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+// Per-worker state: bins[i] holds the vertices this worker moved into bucket
+// i; visited lists the vertices it processed in the current bucket.
+template <typename Id>
+struct alignas(64) Worker {
+    std::vector<std::vector<Id>> bins;
+    std::vector<Id> visited;
+
+    void add(size_t bucket, Id v) {
+        if (bucket >= bins.size()) bins.resize(bucket + 1);
+        bins[bucket].push_back(v);
+    }
+};
+
+// Largest weight and whether any weight is negative, in parallel.
+template <typename Id, typename Weight>
+std::pair<Weight, bool> scanWeights(const CsrGraph<Id, Weight>& graph, ThreadPool& pool) {
+    size_t tasks = pool.size() * 4;
+    std::vector<Weight> maxima(tasks, Weight(0));
+    std::vector<char> negative(tasks, 0);
+    uint64_t m = graph.numEdges();
+    pool.parallelFor(tasks, [&](size_t t) {
+        uint64_t end = m * (t + 1) / tasks;
+        for (uint64_t e = m * t / tasks; e < end; ++e) {
+            Weight w = graph.weight(e);
+            maxima[t] = std::max(maxima[t], w);
+            if (w < Weight(0)) negative[t] = 1;
+        }
+    });
+    return {*std::max_element(maxima.begin(), maxima.end()),
+            std::find(negative.begin(), negative.end(), 1) != negative.end()};
+}
+
+} // namespace delta_stepping_detail
+
+// Shortest distances from source; kDijkstraInfinity for unreachable vertices.
+// Throws std::invalid_argument on a negative weight.
+template <typename Id, typename Weight>
+std::vector<DijkstraDistance<Weight>> deltaStepping(const CsrGraph<Id, Weight>& graph, Id source,
+                                                    const DeltaSteppingOptions& options = {},
+                                                    ThreadPool& pool = defaultThreadPool()) {
+    using namespace delta_stepping_detail;
+    using Distance = DijkstraDistance<Weight>;
+    size_t n = graph.numVertices();
+
+    auto [maxWeight, negative] = scanWeights(graph, pool);
+    if (negative) throw std::invalid_argument("deltaStepping: negative edge weight");
+    double delta = options.delta;
+    if (delta <= 0) {
+        double averageDegree = n ? static_cast<double>(graph.numEdges()) / static_cast<double>(n) : 1.0;
+        delta = static_cast<double>(maxWeight) / std::max(1.0, averageDegree);
+    }
+    if (std::is_integral_v<Weight>) delta = std::max(1.0, delta);
+    if (!(delta > 0)) delta = 1; // All weights are 0
+    auto bucketOf = [delta](Distance d) { return static_cast<size_t>(static_cast<double>(d) / delta); };
+    auto isLight = [delta](Weight w) { return static_cast<double>(w) < delta; };
+
+    std::unique_ptr<std::atomic<Distance>[]> dist(new std::atomic<Distance>[n]);
+    std::unique_ptr<std::atomic<size_t>[]> lastBucket(new std::atomic<size_t>[n]);
+    pool.parallelFor(n, [&](size_t v) {
+        dist[v].store(kDijkstraInfinity<Distance>, std::memory_order_relaxed);
+        lastBucket[v].store(SIZE_MAX, std::memory_order_relaxed);
+    }, 4096);
+    std::vector<Distance> result(n, kDijkstraInfinity<Distance>);
+    if (source >= n) return result;
+
+    size_t workers = pool.size();
+    std::vector<Worker<Id>> state(workers);
+    std::vector<Id> frontier{source};
+    dist[source].store(0, std::memory_order_relaxed);
+    size_t bucket = 0;
+
+    // Runs fn(worker, u) over the frontier, chunks claimed dynamically.
+    auto forFrontier = [&](auto&& fn) {
+        std::atomic<size_t> next{0};
+        pool.parallelFor(workers, [&](size_t w) {
+            size_t begin;
+            while ((begin = next.fetch_add(kChunk, std::memory_order_relaxed)) < frontier.size()) {
+                size_t end = std::min(frontier.size(), begin + kChunk);
+                for (size_t i = begin; i < end; ++i) fn(state[w], frontier[i]);
+            }
+        });
+    };
+    auto relax = [&](Worker<Id>& worker, Id u, Distance du, bool light) {
+        for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+            Weight w = graph.weight(e);
+            if (isLight(w) != light) continue;
+            Id v = graph.target(e);
+            Distance nd = du + static_cast<Distance>(w);
+            if (atomicMin(dist[v], nd)) worker.add(bucketOf(nd), v);
+        }
+    };
+    // Moves bucket b of every worker into the frontier.
+    auto gather = [&](size_t b) {
+        frontier.clear();
+        for (Worker<Id>& worker : state) {
+            if (b >= worker.bins.size()) continue;
+            frontier.insert(frontier.end(), worker.bins[b].begin(), worker.bins[b].end());
+            worker.bins[b].clear();
+        }
+    };
+
+    while (true) {
+        // Light phase, until the bucket stays empty
+        while (!frontier.empty()) {
+            forFrontier([&](Worker<Id>& worker, Id u) {
+                Distance du = dist[u].load(std::memory_order_relaxed);
+                if (bucketOf(du) != bucket) return; // Stale entry: u has moved to an earlier bucket
+                if (lastBucket[u].exchange(bucket, std::memory_order_relaxed) != bucket) worker.visited.push_back(u);
+                relax(worker, u, du, true);
+            });
+            gather(bucket);
+        }
+
+        // Heavy phase over the vertices settled in this bucket
+        pool.parallelFor(workers, [&](size_t w) {
+            for (Id u : state[w].visited) relax(state[w], u, dist[u].load(std::memory_order_relaxed), false);
+            state[w].visited.clear();
+        });
+
+        // Next non-empty bucket; the current one again if the heavy phase
+        // refilled it (possible only through floating-point rounding)
+        size_t nextBucket = SIZE_MAX;
+        for (const Worker<Id>& worker : state) {
+            for (size_t b = bucket; b < worker.bins.size() && b < nextBucket; ++b) {
+                if (!worker.bins[b].empty()) {
+                    nextBucket = b;
+                    break;
+                }
+            }
+        }
+        if (nextBucket == SIZE_MAX) break;
+        bucket = nextBucket;
+        gather(bucket);
+    }
+
+    pool.parallelFor(n, [&](size_t v) { result[v] = dist[v].load(std::memory_order_relaxed); }, 4096);
+    return result;
+}
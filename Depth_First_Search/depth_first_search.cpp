@@ -1,5 +1,11 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+#include "../CSR_Graph/csr_graph.h"
+#include "depth_first_search.h"
 using namespace std;
 
 void dfsHelper(const vector<vector<int>>& graph, int node, vector<bool>& visited) {
@@ -18,6 +24,17 @@ void dfs(const vector<vector<int>>& graph, int start) {
     dfsHelper(graph, start, visited);
 }
 
+// The same traversal on the shared CSR graph type, with the explicit-stack
+// engine from depth_first_search.h, so long paths do not overflow the stack
+struct PrintVisitor : DfsVisitor<uint32_t> {
+    void discover(uint32_t node) { cout << node << " "; }
+};
+
+void dfs(const CsrGraph<>& graph, uint32_t start) {
+    PrintVisitor printer;
+    depthFirstSearch(graph, start, printer);
+}
+
 int main() {
     vector<vector<int>> graph = {
         {1, 2},  // Node 0 is connected to 1 and 2
@@ -29,6 +46,70 @@ int main() {
 
     cout << "DFS Traversal: ";
     dfs(graph, 0);
+    cout << endl;
+
+    cout << "DFS Traversal (CSR): ";
+    dfs(CsrGraph<>::fromAdjacencyList(graph), 0);
+    cout << endl;
+
+    // Strongly connected components: 0 -> 1 -> 2 -> 0 is a cycle, 3 -> 4 -> 3
+    // another, and 2 -> 3 links them
+    CsrGraph<> directed = CsrGraph<>::fromAdjacencyList(vector<vector<int>>{{1}, {2}, {0, 3}, {4}, {3}});
+    StronglyConnectedComponents<uint32_t> scc = stronglyConnectedComponents(directed);
+    cout << scc.count << " strongly connected components:";
+    for (uint32_t c : scc.component) cout << " " << c;
+    cout << endl;
+
+    // The example graph is a tree: every vertex with two neighbors is a cut vertex
+    cout << "Articulation points:";
+    for (uint32_t v : articulationPoints(CsrGraph<>::fromAdjacencyList(graph))) cout << " " << v;
+    cout << endl;
+
+    // A dependency graph with 10M nodes: a chain through every node (a DFS
+    // 10M levels deep) plus 3 random dependencies on later nodes each
+    const size_t n = 10000000;
+    mt19937_64 rng(5);
+    vector<pair<uint32_t, uint32_t>> edges;
+    edges.reserve(4 * n);
+    for (uint32_t v = 0; v + 1 < n; ++v) {
+        edges.push_back({v, v + 1});
+        for (int k = 0; k < 3; ++k) edges.push_back({v, uint32_t(v + 1 + rng() % (n - v - 1))});
+    }
+    CsrGraph<> deps = CsrGraph<>::fromEdges(n, edges);
+    cout << "Dependency graph: " << deps.numVertices() << " nodes, " << deps.numEdges() << " edges" << endl;
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    auto start = chrono::steady_clock::now();
+    DfsVisitor<uint32_t> none;
+    depthFirstSearch(deps, 0u, none);
+    cout << "  DFS, empty visitor:   " << since(start) << " ms" << endl;
+
+    start = chrono::steady_clock::now();
+    vector<uint32_t> order = topologicalSort(deps);
+    double topoMs = since(start);
+    vector<uint32_t> position(n);
+    for (size_t i = 0; i < n; ++i) position[order[i]] = uint32_t(i);
+    bool sorted = true;
+    deps.forEachEdge([&](uint32_t u, uint32_t v, int32_t) { sorted = sorted && position[u] < position[v]; });
+    cout << "  topological sort:     " << topoMs << " ms, valid: " << (sorted ? "yes" : "no") << endl;
+
+    start = chrono::steady_clock::now();
+    StronglyConnectedComponents<uint32_t> acyclic = stronglyConnectedComponents(deps);
+    cout << "  SCC:                  " << since(start) << " ms, " << acyclic.count << " components" << endl;
+
+    // One edge back from the last node to node 0 closes a cycle through everything
+    edges.push_back({uint32_t(n - 1), 0});
+    CsrGraph<> cyclic = CsrGraph<>::fromEdges(n, edges);
+    start = chrono::steady_clock::now();
+    StronglyConnectedComponents<uint32_t> one = stronglyConnectedComponents(cyclic);
+    cout << "  SCC with a back edge: " << since(start) << " ms, " << one.count << " component" << endl;
+    try {
+        topologicalSort(cyclic);
+    } catch (const invalid_argument& e) {
+        cout << "  " << e.what() << endl;
+    }
     return 0;
 }
 
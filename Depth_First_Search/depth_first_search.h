@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+
+// Depth-first search on a CsrGraph with an explicit stack, so the depth of the
+// search is limited by memory rather than by the call stack (a recursive DFS
+// overflows on paths of about 100k vertices).
+//
+// Each stack frame is a vertex and the position of its next unexplored edge.
+// A visitor sees the search through these callbacks:
+//     root(v)            v starts a new DFS tree
+//     discover(v)        pre-order: v is reached for the first time
+//     treeEdge(u, v)     u -> v leads to undiscovered v (called before discover(v))
+//     otherEdge(u, v)    u -> v leads to an already discovered v (back, forward or cross edge)
+//     finishEdge(u, v)   the search returns to u after finishing v through u -> v
+//     finish(v)          post-order: every edge of v has been explored
+// DfsVisitor has empty versions of all of them. A visitor derives from it and
+// redefines only what it needs; the calls are resolved at compile time, so
+// unused callbacks cost nothing.
+//
+// Neighbors are explored in the order of the CSR neighbor list, so the visit
+// order is the same as that of the recursive DFS.
+//
+// Tarjan's strongly connected components, topological sort and articulation
+// points are built on top of the engine.
+
+template <typename Id>
+struct DfsVisitor {
+    void root(Id) {}
+    void discover(Id) {}
+    void treeEdge(Id, Id) {}
+    void otherEdge(Id, Id) {}
+    void finishEdge(Id, Id) {}
+    void finish(Id) {}
+};
+
+template <typename Id, typename Weight>
+class DepthFirstSearch {
+public:
+    explicit DepthFirstSearch(const CsrGraph<Id, Weight>& graph) : graph(graph), seen(graph.numVertices(), 0) {}
+
+    bool discovered(Id v) const { return seen[v] != 0; }
+
+    // Forgets every discovered vertex.
+    void reset() { std::fill(seen.begin(), seen.end(), 0); }
+
+    // Explores everything reachable from start that is not yet discovered.
+    template <typename Visitor>
+    void run(Id start, Visitor& visitor) {
+        if (seen[start]) return;
+        visitor.root(start);
+        enter(start, visitor);
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (frame.next < graph.edgeEnd(frame.vertex)) {
+                Id u = frame.vertex;
+                Id v = graph.target(frame.next++);
+                if (!seen[v]) {
+                    visitor.treeEdge(u, v);
+                    enter(v, visitor); // frame is invalid from here on
+                } else {
+                    visitor.otherEdge(u, v);
+                }
+            } else {
+                Id v = frame.vertex;
+                stack.pop_back();
+                visitor.finish(v);
+                if (!stack.empty()) visitor.finishEdge(stack.back().vertex, v);
+            }
+        }
+    }
+
+    // Runs from every undiscovered vertex in increasing id order.
+    template <typename Visitor>
+    void runAll(Visitor& visitor) {
+        for (size_t v = 0; v < graph.numVertices(); ++v) run(static_cast<Id>(v), visitor);
+    }
+
+private:
+    struct Frame {
+        Id vertex;
+        uint64_t next; // Next edge to explore
+    };
+
+    template <typename Visitor>
+    void enter(Id v, Visitor& visitor) {
+        seen[v] = 1;
+        visitor.discover(v);
+        stack.push_back({v, graph.edgeBegin(v)});
+    }
+
+    const CsrGraph<Id, Weight>& graph;
+    std::vector<uint8_t> seen;
+    std::vector<Frame> stack;
+};
+
+// Runs a DFS from start with the given visitor.
+template <typename Id, typename Weight, typename Visitor>
+void depthFirstSearch(const CsrGraph<Id, Weight>& graph, Id start, Visitor& visitor) {
+    DepthFirstSearch<Id, Weight>(graph).run(start, visitor);
+}
+
+template <typename Id>
+constexpr Id kDfsNone = std::numeric_limits<Id>::max();
+
+template <typename Id>
+struct StronglyConnectedComponents {
+    std::vector<Id> component; // Component of every vertex
+    size_t count = 0;
+};
+
+namespace dfs_detail {
+
+// Tarjan: index[v] is the discovery time, low[v] the smallest index reachable
+// from v's subtree through one non-tree edge to a vertex still on the
+// component stack. A vertex with low == index closes a component. A discovered
+// vertex is on the component stack exactly while its component is unassigned,
+// so no separate on-stack flag is kept.
+template <typename Id>
+struct TarjanVisitor : DfsVisitor<Id> {
+    explicit TarjanVisitor(size_t n) : index(n), low(n), result{std::vector<Id>(n, kDfsNone<Id>), 0} {}
+
+    void discover(Id v) {
+        index[v] = low[v] = next++;
+        pending.push_back(v);
+    }
+    void otherEdge(Id u, Id v) {
+        if (result.component[v] == kDfsNone<Id>) low[u] = std::min(low[u], index[v]);
+    }
+    void finishEdge(Id u, Id v) { low[u] = std::min(low[u], low[v]); }
+    void finish(Id v) {
+        if (low[v] != index[v]) return;
+        Id id = static_cast<Id>(result.count++);
+        Id w;
+        do {
+            w = pending.back();
+            pending.pop_back();
+            result.component[w] = id;
+        } while (w != v);
+    }
+
+    std::vector<Id> index, low, pending;
+    Id next = 0;
+    StronglyConnectedComponents<Id> result;
+};
+
+template <typename Id>
+struct TopologicalVisitor : DfsVisitor<Id> {
+    explicit TopologicalVisitor(size_t n) : finished(n, 0) { order.reserve(n); }
+
+    void otherEdge(Id, Id v) {
+        // A discovered but unfinished vertex is on the DFS stack: a back edge
+        if (!finished[v]) throw std::invalid_argument("topologicalSort: graph has a cycle");
+    }
+    void finish(Id v) {
+        finished[v] = 1;
+        order.push_back(v);
+    }
+
+    std::vector<uint8_t> finished;
+    std::vector<Id> order;
+};
+
+// Hopcroft-Tarjan: a non-root vertex u is an articulation point if some child
+// v has low[v] >= index[u]; a root if it has two or more children. The edge
+// back to the parent is skipped once, so a parallel edge still counts.
+template <typename Id>
+struct ArticulationVisitor : DfsVisitor<Id> {
+    explicit ArticulationVisitor(size_t n) : index(n), low(n), parent(n, kDfsNone<Id>), cut(n, 0) {}
+
+    void root(Id v) {
+        rootVertex = v;
+        rootChildren = 0;
+    }
+    void discover(Id v) { index[v] = low[v] = next++; }
+    void treeEdge(Id u, Id v) {
+        parent[v] = u;
+        if (u == rootVertex) ++rootChildren;
+    }
+    void otherEdge(Id u, Id v) {
+        if (v == parent[u]) {
+            parent[u] = kDfsNone<Id>; // Only the first edge back to the parent is the tree edge
+            return;
+        }
+        low[u] = std::min(low[u], index[v]);
+    }
+    void finishEdge(Id u, Id v) {
+        low[u] = std::min(low[u], low[v]);
+        if (u != rootVertex && low[v] >= index[u]) cut[u] = 1;
+    }
+    void finish(Id v) {
+        if (v == rootVertex && rootChildren > 1) cut[v] = 1;
+    }
+
+    std::vector<Id> index, low, parent;
+    std::vector<uint8_t> cut;
+    Id next = 0, rootVertex = 0;
+    size_t rootChildren = 0;
+};
+
+} // namespace dfs_detail
+
+// Strongly connected components of a directed graph (iterative Tarjan).
+// Components are numbered in reverse topological order of the condensation:
+// component 0 has no edges to other components.
+template <typename Id, typename Weight>
+StronglyConnectedComponents<Id> stronglyConnectedComponents(const CsrGraph<Id, Weight>& graph) {
+    dfs_detail::TarjanVisitor<Id> visitor(graph.numVertices());
+    DepthFirstSearch<Id, Weight>(graph).runAll(visitor);
+    return std::move(visitor.result);
+}
+
+// Vertices of a DAG such that every edge goes from an earlier to a later
+// vertex (reverse DFS post-order). Throws std::invalid_argument on a cycle.
+template <typename Id, typename Weight>
+std::vector<Id> topologicalSort(const CsrGraph<Id, Weight>& graph) {
+    dfs_detail::TopologicalVisitor<Id> visitor(graph.numVertices());
+    DepthFirstSearch<Id, Weight>(graph).runAll(visitor);
+    std::reverse(visitor.order.begin(), visitor.order.end());
+    return std::move(visitor.order);
+}
+
+// Articulation points (cut vertices) of an undirected graph, every edge stored
+// in both directions, in increasing id order.
+template <typename Id, typename Weight>
+std::vector<Id> articulationPoints(const CsrGraph<Id, Weight>& graph) {
+    dfs_detail::ArticulationVisitor<Id> visitor(graph.numVertices());
+    DepthFirstSearch<Id, Weight>(graph).runAll(visitor);
+    std::vector<Id> points;
+    for (size_t v = 0; v < graph.numVertices(); ++v) {
+        if (visitor.cut[v]) points.push_back(static_cast<Id>(v));
+    }
+    return points;
+}
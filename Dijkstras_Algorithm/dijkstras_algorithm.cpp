@@ -1,6 +1,11 @@
 #include <iostream>
 #include <vector>
 #include <queue>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "dijkstras_algorithm.h"
 using namespace std;
 
 const int INF = 1e9;
@@ -36,6 +41,38 @@ void dijkstra(const vector<vector<pair<int, int>>>& graph, int start) {
     }
 }
 
+// The same algorithm on the shared CSR graph type
+void dijkstra(const CsrGraph<>& graph, uint32_t start) {
+    vector<int> dist(graph.numVertices(), INF);
+    priority_queue<pair<int, uint32_t>, vector<pair<int, uint32_t>>, greater<>> pq;
+
+    dist[start] = 0;
+    pq.push({0, start});
+
+    while (!pq.empty()) {
+        int currDist = pq.top().first;
+        uint32_t node = pq.top().second;
+        pq.pop();
+
+        if (currDist > dist[node]) continue;
+
+        for (uint64_t e = graph.edgeBegin(node); e < graph.edgeEnd(node); ++e) {
+            uint32_t neighbor = graph.target(e);
+            int weight = graph.weight(e);
+
+            if (dist[node] + weight < dist[neighbor]) {
+                dist[neighbor] = dist[node] + weight;
+                pq.push({dist[neighbor], neighbor});
+            }
+        }
+    }
+
+    cout << "Shortest distances from node " << start << " (CSR):\n";
+    for (size_t i = 0; i < dist.size(); ++i) {
+        cout << "Node " << i << ": " << dist[i] << endl;
+    }
+}
+
 int main() {
     vector<vector<pair<int, int>>> graph = {
         {{1, 2}, {2, 4}},  // Node 0 -> 1 (weight 2), 0 -> 2 (weight 4)
@@ -45,6 +82,106 @@ int main() {
     };
 
     dijkstra(graph, 0);
+    CsrGraph<> csr = CsrGraph<>::fromAdjacencyList(graph);
+    dijkstra(csr, 0);
+
+    // Point-to-point with path reconstruction
+    ShortestPath<uint32_t, int64_t> route = shortestPath(csr, 0u, 3u);
+    cout << "Shortest path 0 -> 3 (length " << route.distance << "):";
+    for (uint32_t v : route.path) cout << " " << v;
+    cout << endl;
+
+    // A road-like grid: 1000 x 1000 intersections, streets in both directions
+    // with travel times 1..100
+    const uint32_t side = 1000, n = side * side;
+    mt19937_64 rng(17);
+    vector<CsrEdge<uint32_t, int32_t>> streets;
+    for (uint32_t r = 0; r < side; ++r) {
+        for (uint32_t c = 0; c < side; ++c) {
+            uint32_t v = r * side + c;
+            if (c + 1 < side) streets.push_back({v, v + 1, int32_t(1 + rng() % 100)});
+            if (r + 1 < side) streets.push_back({v, v + side, int32_t(1 + rng() % 100)});
+        }
+    }
+    CsrBuildOptions undirected;
+    undirected.symmetrize = true;
+    CsrGraph<> roads = CsrGraph<>::fromEdges(n, streets, undirected);
+    CsrGraph<> reverse = roads.reversed();
+    cout << "Road grid: " << roads.numVertices() << " vertices, " << roads.numEdges() << " edges" << endl;
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    // Full single-source runs
+    auto start = chrono::steady_clock::now();
+    vector<int64_t> lazy(n, INT64_MAX);
+    priority_queue<pair<int64_t, uint32_t>, vector<pair<int64_t, uint32_t>>, greater<>> pq;
+    lazy[0] = 0;
+    pq.push({0, 0});
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > lazy[u]) continue;
+        for (uint64_t e = roads.edgeBegin(u); e < roads.edgeEnd(u); ++e) {
+            if (d + roads.weight(e) < lazy[roads.target(e)]) {
+                lazy[roads.target(e)] = d + roads.weight(e);
+                pq.push({lazy[roads.target(e)], roads.target(e)});
+            }
+        }
+    }
+    cout << "Full run from vertex 0:" << endl;
+    cout << "  priority_queue with duplicates: " << since(start) << " ms" << endl;
+    for (DijkstraQueue queue : {DijkstraQueue::DaryHeap, DijkstraQueue::RadixHeap}) {
+        DijkstraOptions options;
+        options.queue = queue;
+        start = chrono::steady_clock::now();
+        DijkstraResult<uint32_t, int64_t> full = dijkstra(roads, 0u, options);
+        cout << (queue == DijkstraQueue::DaryHeap ? "  indexed 4-ary heap:            " : "  radix heap:                     ")
+             << since(start) << " ms, same distances: " << (full.distance == lazy ? "yes" : "no") << endl;
+    }
+
+    // Point-to-point queries between random intersections
+    const int queries = 200;
+    vector<pair<uint32_t, uint32_t>> pairs(queries);
+    for (auto& q : pairs) q = {uint32_t(rng() % n), uint32_t(rng() % n)};
+    DijkstraSearch<uint32_t, int32_t> forward(roads), backward(reverse);
+    DijkstraSearch<uint32_t, int32_t, RadixHeapQueue<uint32_t, int32_t>> radix(roads);
+    vector<int64_t> expected(queries);
+    auto timeQueries = [&](const char* name, auto&& query) {
+        start = chrono::steady_clock::now();
+        size_t settled = 0;
+        bool same = true;
+        for (int i = 0; i < queries; ++i) {
+            auto [distance, count] = query(pairs[i].first, pairs[i].second);
+            settled += count;
+            if (name[0] == 'f') expected[i] = distance;
+            same = same && distance == expected[i];
+        }
+        cout << "  " << name << since(start) / queries << " ms, " << settled / queries << " settled per query, same: "
+             << (same ? "yes" : "no") << endl;
+    };
+    cout << "Point-to-point, average of " << queries << " queries:" << endl;
+    timeQueries("full run:          ", [&](uint32_t s, uint32_t t) {
+        forward.run(s);
+        return make_pair(forward.distance(t), forward.settledCount());
+    });
+    timeQueries("stop at target:    ", [&](uint32_t s, uint32_t t) {
+        forward.run(s, t);
+        return make_pair(forward.distance(t), forward.settledCount());
+    });
+    timeQueries("radix heap, stop:  ", [&](uint32_t s, uint32_t t) {
+        radix.run(s, t);
+        return make_pair(radix.distance(t), radix.settledCount());
+    });
+    timeQueries("bidirectional:     ", [&](uint32_t s, uint32_t t) {
+        ShortestPath<uint32_t, int64_t> p = bidirectionalShortestPath<uint32_t, int32_t>(forward, backward, s, t);
+        return make_pair(p.distance, p.settled);
+    });
+
+    // Multi-source: distance from every vertex to the nearest of 4 depots
+    DijkstraResult<uint32_t, int64_t> depots = dijkstra(roads, vector<uint32_t>{0, side - 1, n - side, n - 1});
+    cout << "Farthest distance from the 4 corner depots: " << *max_element(depots.distance.begin(), depots.distance.end())
+         << endl;
     return 0;
 }
 
@@ -0,0 +1,442 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+
+// Dijkstra's algorithm on a CsrGraph with a choice of priority queue, for full
+// single- or multi-source runs and for point-to-point queries.
+//
+// Queues:
+// - IndexedDaryHeap: a 4-ary min-heap that knows the position of every vertex,
+//   so a shorter distance moves the vertex up (decrease-key) instead of adding
+//   a duplicate entry. The heap never holds more than one entry per vertex, and
+//   its shallow tree keeps sift-downs within a few cache lines.
+// - RadixHeap: for integer weights only. It relies on Dijkstra popping keys in
+//   non-decreasing order: bucket i holds keys whose highest bit that differs
+//   from the last popped key is bit i - 1. A key moves to lower buckets at most
+//   64 times, so an operation is O(1) amortized plus O(log C) for the largest
+//   weight C. Improved distances are pushed as new entries; stale ones are
+//   skipped on pop.
+//
+// A DijkstraSearch keeps its arrays between queries and resets only the
+// vertices the last query touched, so a point-to-point query that stops when
+// its target settles costs time proportional to the part of the graph it
+// explored, not to the size of the graph.
+//
+// Distances are int64_t for integer weights and double for floating-point
+// ones. Negative weights throw std::invalid_argument when they are reached.
+
+template <typename Weight>
+using DijkstraDistance = std::conditional_t<std::is_floating_point_v<Weight>, double, int64_t>;
+
+template <typename Distance>
+constexpr Distance kDijkstraInfinity = std::numeric_limits<Distance>::max();
+
+template <typename Id>
+constexpr Id kDijkstraNone = std::numeric_limits<Id>::max();
+
+enum class DijkstraQueue { DaryHeap, RadixHeap };
+
+struct DijkstraOptions {
+    DijkstraQueue queue = DijkstraQueue::DaryHeap;
+};
+
+// Indexed d-ary min-heap of vertices 0..n-1 keyed by distance.
+template <typename Id, typename Key, size_t Arity = 4>
+class IndexedDaryHeap {
+public:
+    explicit IndexedDaryHeap(size_t n) : position(n, kAbsent) {}
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(Id v) const { return position[v] != kAbsent; }
+    Key topKey() const { return heap.front().key; }
+
+    // Inserts v, or lowers its key if it is already in the heap. A key that is
+    // not lower than the current one is ignored.
+    void push(Id v, Key key) {
+        size_t at = position[v];
+        if (at == kAbsent) {
+            at = heap.size();
+            heap.push_back({key, v});
+        } else if (key < heap[at].key) {
+            heap[at].key = key;
+        } else {
+            return;
+        }
+        siftUp(at);
+    }
+
+    // Removes the vertex with the smallest key; returns (key, vertex).
+    std::pair<Key, Id> pop() {
+        Entry top = heap.front();
+        position[top.vertex] = kAbsent;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) siftDown(last);
+        return {top.key, top.vertex};
+    }
+
+    void clear() {
+        for (const Entry& e : heap) position[e.vertex] = kAbsent;
+        heap.clear();
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Id vertex;
+    };
+
+    static constexpr Id kAbsent = std::numeric_limits<Id>::max();
+
+    void place(size_t at, const Entry& e) {
+        heap[at] = e;
+        position[e.vertex] = static_cast<Id>(at);
+    }
+
+    void siftUp(size_t at) {
+        Entry e = heap[at];
+        while (at > 0) {
+            size_t parent = (at - 1) / Arity;
+            if (!(e.key < heap[parent].key)) break;
+            place(at, heap[parent]);
+            at = parent;
+        }
+        place(at, e);
+    }
+
+    // Moves e down from the root into the hole left by the popped entry.
+    void siftDown(const Entry& e) {
+        size_t at = 0, n = heap.size();
+        while (true) {
+            size_t first = at * Arity + 1;
+            if (first >= n) break;
+            size_t best = first, end = std::min(first + Arity, n);
+            for (size_t c = first + 1; c < end; ++c) {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+            if (!(heap[best].key < e.key)) break;
+            place(at, heap[best]);
+            at = best;
+        }
+        place(at, e);
+    }
+
+    std::vector<Entry> heap;
+    std::vector<Id> position; // Index in heap, or kAbsent
+};
+
+// Monotone radix heap for non-negative integer keys: a pushed key must not be
+// smaller than the last popped one.
+template <typename Id, typename Key>
+class RadixHeap {
+    static_assert(std::is_integral_v<Key>, "RadixHeap needs integer keys");
+
+public:
+    explicit RadixHeap(size_t = 0) {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(Id v, Key key) {
+        buckets[bucketOf(static_cast<uint64_t>(key))].push_back({static_cast<uint64_t>(key), v});
+        ++count;
+    }
+
+    Key topKey() {
+        refill();
+        return static_cast<Key>(last);
+    }
+
+    std::pair<Key, Id> pop() {
+        refill();
+        Entry e = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return {static_cast<Key>(e.key), e.vertex};
+    }
+
+    void clear() {
+        for (auto& bucket : buckets) bucket.clear();
+        count = 0;
+        last = 0;
+    }
+
+private:
+    struct Entry {
+        uint64_t key;
+        Id vertex;
+    };
+
+    size_t bucketOf(uint64_t key) const { return key == last ? 0 : 64 - __builtin_clzll(key ^ last); }
+
+    // Makes bucket 0 (keys equal to last) non-empty: the smallest key of the
+    // first non-empty bucket becomes last, and that bucket is redistributed
+    // into lower ones.
+    void refill() {
+        if (!buckets[0].empty()) return;
+        size_t i = 1;
+        while (buckets[i].empty()) ++i;
+        last = buckets[i].front().key;
+        for (const Entry& e : buckets[i]) last = std::min(last, e.key);
+        for (const Entry& e : buckets[i]) buckets[bucketOf(e.key)].push_back(e);
+        buckets[i].clear();
+    }
+
+    std::array<std::vector<Entry>, 65> buckets;
+    size_t count = 0;
+    uint64_t last = 0;
+};
+
+template <typename Id, typename Weight>
+using DaryHeapQueue = IndexedDaryHeap<Id, DijkstraDistance<Weight>, 4>;
+
+template <typename Id, typename Weight>
+using RadixHeapQueue = RadixHeap<Id, DijkstraDistance<Weight>>;
+
+// A reusable Dijkstra search over one graph.
+template <typename Id, typename Weight, typename Queue = DaryHeapQueue<Id, Weight>>
+class DijkstraSearch {
+public:
+    using Distance = DijkstraDistance<Weight>;
+
+    explicit DijkstraSearch(const CsrGraph<Id, Weight>& graph)
+        : graph(graph), queue(graph.numVertices()), dist(graph.numVertices(), kDijkstraInfinity<Distance>),
+          parentOf(graph.numVertices(), kDijkstraNone<Id>) {}
+
+    // Searches from every source at distance 0. With a target, the search stops
+    // as soon as the target settles; distances of vertices that have not
+    // settled by then are only upper bounds.
+    void run(const Id* sources, size_t count, Id target = kDijkstraNone<Id>) {
+        start(sources, count);
+        while (!queue.empty()) {
+            if (settleNext() == target && target != kDijkstraNone<Id>) break;
+        }
+    }
+
+    void run(const std::vector<Id>& sources, Id target = kDijkstraNone<Id>) {
+        run(sources.data(), sources.size(), target);
+    }
+
+    void run(Id source, Id target = kDijkstraNone<Id>) { run(&source, 1, target); }
+
+    Distance distance(Id v) const { return dist[v]; }
+    bool reached(Id v) const { return dist[v] != kDijkstraInfinity<Distance>; }
+    // Predecessor on the shortest path; a source is its own parent.
+    Id parent(Id v) const { return parentOf[v]; }
+    // Vertices taken off the queue by the last query.
+    size_t settledCount() const { return settled; }
+
+    // Vertices from a source to target; empty if target was not reached.
+    std::vector<Id> path(Id target) const {
+        std::vector<Id> vertices;
+        if (!reached(target)) return vertices;
+        for (Id v = target;; v = parentOf[v]) {
+            vertices.push_back(v);
+            if (parentOf[v] == v) break;
+        }
+        std::reverse(vertices.begin(), vertices.end());
+        return vertices;
+    }
+
+    // Step-wise interface, for searches that drive one or more DijkstraSearch
+    // objects themselves (bidirectional search).
+
+    // Clears the last query and puts the sources in the queue.
+    void start(const Id* sources, size_t count) {
+        for (Id v : touched) {
+            dist[v] = kDijkstraInfinity<Distance>;
+            parentOf[v] = kDijkstraNone<Id>;
+        }
+        touched.clear();
+        queue.clear();
+        settled = 0;
+        for (size_t i = 0; i < count; ++i) {
+            Id s = sources[i];
+            if (dist[s] == 0) continue;
+            touched.push_back(s);
+            dist[s] = 0;
+            parentOf[s] = s;
+            queue.push(s, 0);
+        }
+    }
+
+    bool done() const { return queue.empty(); }
+    // Lower bound on the distance of the next vertex to settle.
+    Distance nextDistance() { return queue.topKey(); }
+
+    // Settles the closest vertex in the queue and relaxes its out-edges;
+    // onImprove(v, d) is called for every vertex whose distance drops to d.
+    // Returns the vertex, or kDijkstraNone for a stale radix heap entry.
+    template <typename OnImprove>
+    Id settleNext(OnImprove&& onImprove) {
+        auto [d, u] = queue.pop();
+        if (d > dist[u]) return kDijkstraNone<Id>;
+        ++settled;
+        for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+            Weight w = graph.weight(e);
+            if constexpr (std::is_signed_v<Weight>) {
+                if (w < 0) throw std::invalid_argument("dijkstra: negative edge weight");
+            }
+            Id v = graph.target(e);
+            Distance nd = d + static_cast<Distance>(w);
+            if (nd < dist[v]) {
+                if (dist[v] == kDijkstraInfinity<Distance>) touched.push_back(v);
+                dist[v] = nd;
+                parentOf[v] = u;
+                queue.push(v, nd);
+                onImprove(v, nd);
+            }
+        }
+        return u;
+    }
+
+    Id settleNext() {
+        return settleNext([](Id, Distance) {});
+    }
+
+private:
+    const CsrGraph<Id, Weight>& graph;
+    Queue queue;
+    std::vector<Distance> dist;
+    std::vector<Id> parentOf;
+    std::vector<Id> touched; // Vertices with a finite distance
+    size_t settled = 0;
+};
+
+template <typename Id, typename Distance>
+struct DijkstraResult {
+    std::vector<Distance> distance; // kDijkstraInfinity if unreachable
+    std::vector<Id> parent;         // kDijkstraNone if unreachable; a source is its own parent
+};
+
+template <typename Id, typename Distance>
+struct ShortestPath {
+    Distance distance = kDijkstraInfinity<Distance>;
+    std::vector<Id> path; // Source to target; empty if unreachable
+    size_t settled = 0;   // Vertices settled to answer the query
+};
+
+namespace dijkstra_detail {
+
+// Calls fn with a DijkstraSearch over graph using the queue chosen in options.
+template <typename Id, typename Weight, typename Fn>
+auto withSearch(const CsrGraph<Id, Weight>& graph, const DijkstraOptions& options, Fn&& fn) {
+    if (options.queue == DijkstraQueue::RadixHeap) {
+        if constexpr (std::is_integral_v<Weight>) {
+            DijkstraSearch<Id, Weight, RadixHeapQueue<Id, Weight>> search(graph);
+            return fn(search);
+        } else {
+            throw std::invalid_argument("dijkstra: the radix heap needs integer weights");
+        }
+    }
+    DijkstraSearch<Id, Weight, DaryHeapQueue<Id, Weight>> search(graph);
+    return fn(search);
+}
+
+} // namespace dijkstra_detail
+
+// Shortest distances and parents from the nearest of several sources.
+template <typename Id, typename Weight>
+DijkstraResult<Id, DijkstraDistance<Weight>> dijkstra(const CsrGraph<Id, Weight>& graph, const std::vector<Id>& sources,
+                                                      const DijkstraOptions& options = {}) {
+    return dijkstra_detail::withSearch(graph, options, [&](auto& search) {
+        search.run(sources);
+        DijkstraResult<Id, DijkstraDistance<Weight>> result;
+        result.distance.resize(graph.numVertices());
+        result.parent.resize(graph.numVertices());
+        for (size_t v = 0; v < graph.numVertices(); ++v) {
+            result.distance[v] = search.distance(static_cast<Id>(v));
+            result.parent[v] = search.parent(static_cast<Id>(v));
+        }
+        return result;
+    });
+}
+
+template <typename Id, typename Weight>
+DijkstraResult<Id, DijkstraDistance<Weight>> dijkstra(const CsrGraph<Id, Weight>& graph, Id source,
+                                                      const DijkstraOptions& options = {}) {
+    return dijkstra(graph, std::vector<Id>{source}, options);
+}
+
+// Point-to-point query that stops when target settles. Issue many queries
+// through one DijkstraSearch instead to reuse its arrays.
+template <typename Id, typename Weight>
+ShortestPath<Id, DijkstraDistance<Weight>> shortestPath(const CsrGraph<Id, Weight>& graph, Id source, Id target,
+                                                        const DijkstraOptions& options = {}) {
+    return dijkstra_detail::withSearch(graph, options, [&](auto& search) {
+        search.run(source, target);
+        ShortestPath<Id, DijkstraDistance<Weight>> result;
+        result.distance = search.distance(target);
+        result.path = search.path(target);
+        result.settled = search.settledCount();
+        return result;
+    });
+}
+
+// Bidirectional point-to-point search: a forward search from source on graph
+// and a backward one from target on reverse (graph.reversed()) take turns,
+// the side with the closer next vertex going first. best is the shortest
+// source-target path seen so far through a vertex labeled by both sides; the
+// search stops once the two next distances add up to at least best, which on
+// road networks happens after settling roughly two balls of half the radius.
+template <typename Id, typename Weight, typename Forward, typename Backward>
+ShortestPath<Id, DijkstraDistance<Weight>> bidirectionalShortestPath(Forward& forward, Backward& backward, Id source,
+                                                                     Id target) {
+    using Distance = DijkstraDistance<Weight>;
+    ShortestPath<Id, Distance> result;
+    forward.start(&source, 1);
+    backward.start(&target, 1);
+    Distance best = kDijkstraInfinity<Distance>;
+    Id meeting = kDijkstraNone<Id>;
+    if (source == target) {
+        best = 0;
+        meeting = source;
+    }
+    auto meet = [&](const auto& other) {
+        return [&](Id v, Distance d) {
+            if (other.reached(v) && d + other.distance(v) < best) {
+                best = d + other.distance(v);
+                meeting = v;
+            }
+        };
+    };
+    auto onForward = meet(backward);
+    auto onBackward = meet(forward);
+    while (!forward.done() && !backward.done()) {
+        Distance f = forward.nextDistance(), b = backward.nextDistance();
+        if (best != kDijkstraInfinity<Distance> && f + b >= best) break;
+        if (f <= b) forward.settleNext(onForward);
+        else backward.settleNext(onBackward);
+    }
+    result.settled = forward.settledCount() + backward.settledCount();
+    if (meeting == kDijkstraNone<Id>) return result;
+    result.distance = best;
+    result.path = forward.path(meeting);
+    for (Id v = meeting; v != target;) {
+        v = backward.parent(v);
+        result.path.push_back(v);
+    }
+    return result;
+}
+
+template <typename Id, typename Weight>
+ShortestPath<Id, DijkstraDistance<Weight>> bidirectionalShortestPath(const CsrGraph<Id, Weight>& graph,
+                                                                     const CsrGraph<Id, Weight>& reverse, Id source,
+                                                                     Id target, const DijkstraOptions& options = {}) {
+    return dijkstra_detail::withSearch(graph, options, [&](auto& forward) {
+        return dijkstra_detail::withSearch(reverse, options, [&](auto& backward) {
+            return bidirectionalShortestPath<Id, Weight>(forward, backward, source, target);
+        });
+    });
+}
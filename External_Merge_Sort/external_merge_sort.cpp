@@ -0,0 +1,70 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+#include "external_merge_sort.h"
+using namespace std;
+
+struct LogRecord {
+    uint64_t timestamp;
+    uint64_t payload; // Original position, used to check stability
+};
+
+bool byTimestamp(const LogRecord& a, const LogRecord& b) {
+    return a.timestamp < b.timestamp;
+}
+
+int main() {
+    const string inputPath = "records.bin";
+    const string outputPath = "sorted.bin";
+    const size_t n = 4000000; // 64 MB of 16-byte records
+
+    // Generate the input file in blocks
+    mt19937_64 rng(42);
+    FILE* out = fopen(inputPath.c_str(), "wb");
+    vector<LogRecord> block(1 << 16);
+    for (size_t written = 0; written < n; written += block.size()) {
+        size_t count = min(block.size(), n - written);
+        for (size_t i = 0; i < count; ++i) block[i] = {rng() % 1000000, written + i};
+        fwrite(block.data(), sizeof(LogRecord), count, out);
+    }
+    fclose(out);
+
+    ExternalSortOptions options;
+    options.memoryBudget = 8 << 20; // 8 MB budget for a 64 MB file
+    options.ioBlockSize = 1 << 20;
+    options.progressInterval = 0.25;
+    options.onProgress = [](const ExternalSortProgress& p) {
+        cout << "  " << p.phase << ": " << p.bytesDone * 100 / p.bytesTotal << "% ("
+             << p.mbPerSecond << " MB/s)\n";
+    };
+
+    cout << "Sorting " << n << " records with an 8 MB memory budget:\n";
+    ExternalSortStats stats = externalMergeSort<LogRecord>(inputPath, outputPath, byTimestamp, options);
+    cout << "Initial runs: " << stats.initialRuns << ", merge passes: " << stats.mergePasses
+         << ", time: " << stats.seconds << " s\n";
+
+    // Verify order and stability by streaming the output back
+    FILE* in = fopen(outputPath.c_str(), "rb");
+    LogRecord prev = {0, 0};
+    size_t count = 0;
+    bool ok = true;
+    size_t got;
+    while ((got = fread(block.data(), sizeof(LogRecord), block.size(), in)) > 0) {
+        for (size_t i = 0; i < got; ++i, ++count) {
+            const LogRecord& r = block[i];
+            if (count > 0 && (r.timestamp < prev.timestamp ||
+                              (r.timestamp == prev.timestamp && r.payload < prev.payload))) {
+                ok = false;
+            }
+            prev = r;
+        }
+    }
+    fclose(in);
+    cout << "Records: " << count << ", sorted and stable: " << (ok && count == n ? "yes" : "no") << endl;
+
+    remove(inputPath.c_str());
+    remove(outputPath.c_str());
+    return 0;
+}
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "../K_Way_Merge/k_way_merge.h"
+#include "../Merge_Sort/merge_sort.h"
+
+// External merge sort for files of fixed-width records that do not fit in RAM.
+//
+// Phase 1 (run formation): the input is read in chunks of a third of the
+// memory budget. While one chunk is sorted with parallelMergeSort, the next
+// one is already being read, and the previous sorted run is being written to
+// a temporary file. All file I/O happens on one background I/O thread in large
+// sequential blocks.
+//
+// Phase 2 (merging): runs are merged with the loser tree from K_Way_Merge,
+// which costs at most ceil(log2 k) comparisons per record. Every run reader and the output writer are double
+// buffered, so the next block is in flight while the current one is consumed.
+// If there are too many runs for the budget or for the process's limit on
+// open files, intermediate merge passes reduce the number of runs first.
+//
+// A run file is only open while it is written or merged, and temporary runs
+// are deleted if the sort throws.
+//
+// Both phases are stable, so records with equal keys keep their input order.
+
+struct ExternalSortProgress {
+    std::string phase;      // "run formation" or "merge pass N"
+    uint64_t bytesDone = 0;
+    uint64_t bytesTotal = 0;
+    double seconds = 0;     // Since the start of this phase
+    double mbPerSecond = 0;
+};
+
+struct ExternalSortOptions {
+    size_t memoryBudget = size_t(256) << 20;   // Bytes for all buffers together
+    size_t ioBlockSize = size_t(4) << 20;      // Preferred read/write size
+    size_t minIoBlockSize = size_t(64) << 10;  // Limits merge fan-in
+    std::string tempDir = ".";
+    std::function<void(const ExternalSortProgress&)> onProgress;
+    double progressInterval = 1.0;             // Seconds between progress reports
+};
+
+struct ExternalSortStats {
+    uint64_t records = 0;
+    size_t initialRuns = 0;
+    size_t mergePasses = 0;
+    double seconds = 0;
+};
+
+namespace external_sort_detail {
+
+// Background thread that executes I/O requests in submission order.
+class IoThread {
+public:
+    IoThread() : worker([this] { loop(); }) {}
+
+    ~IoThread() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_one();
+        worker.join();
+    }
+
+    template <typename Fn>
+    auto submit(Fn fn) -> std::future<decltype(fn())> {
+        auto task = std::make_shared<std::packaged_task<decltype(fn())()>>(std::move(fn));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push([task] { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+private:
+    void loop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::queue<std::function<void()>> tasks;
+    bool stopping = false;
+    std::thread worker;
+};
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { if (f) std::fclose(f); }
+};
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+inline File openFile(const std::string& path, const char* mode) {
+    File f(std::fopen(path.c_str(), mode));
+    if (!f) throw std::runtime_error("external sort: cannot open " + path);
+    return f;
+}
+
+// The soft limit on open file descriptors, or SIZE_MAX if there is none.
+inline size_t openFileLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) return SIZE_MAX;
+    return static_cast<size_t>(limit.rlim_cur);
+}
+
+inline uint64_t fileSize(std::FILE* f) {
+    std::fseek(f, 0, SEEK_END);
+    long long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    if (size < 0) throw std::runtime_error("external sort: cannot determine file size");
+    return static_cast<uint64_t>(size);
+}
+
+template <typename T>
+size_t readRecords(std::FILE* f, T* dst, size_t count) {
+    size_t got = std::fread(dst, sizeof(T), count, f);
+    if (got != count && std::ferror(f)) throw std::runtime_error("external sort: read failed");
+    return got;
+}
+
+template <typename T>
+void writeRecords(std::FILE* f, const T* src, size_t count) {
+    if (std::fwrite(src, sizeof(T), count, f) != count) {
+        throw std::runtime_error("external sort: write failed");
+    }
+}
+
+// Sequential reader over one sorted run with two alternating blocks. Serves as
+// a LoserTree cursor.
+template <typename T>
+class RunReader {
+public:
+    RunReader(const std::string& path, size_t blockRecords, IoThread& io)
+        : file(openFile(path, "rb")), io(io), current(blockRecords), next(blockRecords) {
+        length = readRecords(file.get(), current.data(), current.size());
+        requestNext();
+    }
+
+    RunReader(RunReader&&) = default;
+
+    // A read still in flight targets `next`, so it must finish first.
+    ~RunReader() {
+        if (pending.valid()) pending.wait();
+    }
+
+    bool exhausted() const { return pos == length; }
+    const T& head() const { return current[pos]; }
+
+    void advance() {
+        if (++pos < length) return;
+        if (!pending.valid()) return; // End of run; exhausted() is now true
+        length = pending.get();
+        std::swap(current, next);
+        pos = 0;
+        if (length == current.size()) requestNext();
+    }
+
+private:
+    void requestNext() {
+        std::FILE* f = file.get();
+        T* dst = next.data();
+        size_t count = next.size();
+        pending = io.submit([f, dst, count] { return readRecords(f, dst, count); });
+    }
+
+    File file;
+    IoThread& io;
+    std::vector<T> current, next;
+    size_t pos = 0, length = 0;
+    std::future<size_t> pending;
+};
+
+// Sequential writer with two alternating blocks.
+template <typename T>
+class RunWriter {
+public:
+    RunWriter(const std::string& path, size_t blockRecords, IoThread& io)
+        : file(openFile(path, "wb")), io(io), current(blockRecords), flushing(blockRecords) {}
+
+    ~RunWriter() {
+        if (pending.valid()) pending.wait();
+    }
+
+    void push(const T& x) {
+        current[length++] = x;
+        if (length == current.size()) flush();
+    }
+
+    void close() {
+        flush();
+        if (pending.valid()) pending.get();
+        if (std::fflush(file.get()) != 0) throw std::runtime_error("external sort: flush failed");
+    }
+
+private:
+    void flush() {
+        if (pending.valid()) pending.get(); // The other block must be written out first
+        std::swap(current, flushing);
+        std::FILE* f = file.get();
+        const T* src = flushing.data();
+        size_t count = length;
+        pending = io.submit([f, src, count] { writeRecords(f, src, count); });
+        length = 0;
+    }
+
+    File file;
+    IoThread& io;
+    std::vector<T> current, flushing;
+    size_t length = 0;
+    std::future<void> pending;
+};
+
+// Deletes the temporary files that are still registered when it goes out of
+// scope, so an exception does not leave runs on disk.
+class TempFiles {
+public:
+    TempFiles() = default;
+    TempFiles(const TempFiles&) = delete;
+    TempFiles& operator=(const TempFiles&) = delete;
+
+    ~TempFiles() {
+        for (const auto& path : paths) std::remove(path.c_str());
+    }
+
+    void add(const std::string& path) { paths.push_back(path); }
+
+    void remove(const std::string& path) {
+        std::remove(path.c_str());
+        paths.erase(std::find(paths.begin(), paths.end(), path));
+    }
+
+private:
+    std::vector<std::string> paths;
+};
+
+class ProgressReporter {
+public:
+    ProgressReporter(const ExternalSortOptions& options, std::string phase, uint64_t bytesTotal)
+        : options(options), start(std::chrono::steady_clock::now()) {
+        progress.phase = std::move(phase);
+        progress.bytesTotal = bytesTotal;
+    }
+
+    // Reports at most once per progressInterval, and always on completion.
+    void update(uint64_t bytesDone) {
+        if (!options.onProgress) return;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (bytesDone < progress.bytesTotal && seconds < lastReport + options.progressInterval) return;
+        lastReport = seconds;
+        progress.bytesDone = bytesDone;
+        progress.seconds = seconds;
+        progress.mbPerSecond = progress.seconds > 0 ? bytesDone / 1e6 / progress.seconds : 0;
+        options.onProgress(progress);
+    }
+
+private:
+    const ExternalSortOptions& options;
+    std::chrono::steady_clock::time_point start;
+    double lastReport = 0;
+    ExternalSortProgress progress;
+};
+
+// Unique per call: the address of the caller's stats object plus a clock tick.
+inline std::string tempPrefix(const ExternalSortOptions& options, const void* tag) {
+    auto tick = std::chrono::steady_clock::now().time_since_epoch().count();
+    return options.tempDir + "/extsort_" + std::to_string(reinterpret_cast<uintptr_t>(tag)) + "_" +
+           std::to_string(tick);
+}
+
+inline std::string tempPath(const std::string& prefix, size_t pass, size_t run) {
+    return prefix + "_" + std::to_string(pass) + "_" + std::to_string(run) + ".tmp";
+}
+
+template <typename T, typename Compare>
+void mergeRuns(const std::vector<std::string>& inputs, const std::string& output, size_t blockRecords,
+               Compare& cmp, IoThread& io, ProgressReporter& reporter, uint64_t& recordsDone) {
+    std::vector<RunReader<T>> readers;
+    readers.reserve(inputs.size());
+    for (const auto& path : inputs) readers.emplace_back(path, blockRecords, io);
+    RunWriter<T> writer(output, blockRecords, io);
+
+    LoserTree<RunReader<T>, Compare> tree(readers, cmp);
+    while (!tree.empty()) {
+        writer.push(tree.top());
+        tree.pop();
+        if (++recordsDone % blockRecords == 0) reporter.update(recordsDone * sizeof(T));
+    }
+    writer.close();
+}
+
+} // namespace external_sort_detail
+
+// Sorts the fixed-width records of `inputPath` into `outputPath` using at most
+// about options.memoryBudget bytes of buffers. T must be trivially copyable.
+// Throws std::runtime_error on I/O failure.
+template <typename T, typename Compare = std::less<>>
+ExternalSortStats externalMergeSort(const std::string& inputPath, const std::string& outputPath,
+                                    Compare cmp = Compare(),
+                                    const ExternalSortOptions& options = ExternalSortOptions()) {
+    static_assert(std::is_trivially_copyable<T>::value, "records must be trivially copyable");
+    using namespace external_sort_detail;
+    auto start = std::chrono::steady_clock::now();
+    ExternalSortStats stats;
+
+    File input = openFile(inputPath, "rb");
+    uint64_t bytes = fileSize(input.get());
+    if (bytes % sizeof(T) != 0) throw std::runtime_error("external sort: file size is not a multiple of the record size");
+    stats.records = bytes / sizeof(T);
+
+    std::string prefix = tempPrefix(options, &stats);
+    TempFiles temps;
+
+    // Phase 1: two I/O chunks plus the merge sort scratch buffer fit the budget.
+    size_t chunkRecords = std::max<size_t>(1, options.memoryBudget / 3 / sizeof(T));
+    std::vector<T> chunks[2] = {std::vector<T>(std::min<uint64_t>(chunkRecords, stats.records)),
+                                std::vector<T>(std::min<uint64_t>(chunkRecords, stats.records))};
+    std::vector<T> scratch;
+    std::vector<std::string> runs;
+    std::vector<std::future<void>> writes;
+    // Declared after every buffer its tasks use and after temps: on unwinding,
+    // queued I/O finishes before those buffers are freed and the runs deleted.
+    IoThread io;
+    ProgressReporter formation(options, "run formation", bytes);
+
+    auto readChunk = [&](int which) {
+        std::FILE* f = input.get();
+        std::vector<T>* chunk = &chunks[which];
+        return io.submit([f, chunk] { return readRecords(f, chunk->data(), chunk->size()); });
+    };
+
+    uint64_t recordsRead = 0;
+    int active = 0;
+    std::future<size_t> pendingRead = readChunk(active);
+    while (recordsRead < stats.records) {
+        size_t count = pendingRead.get();
+        if (count == 0) throw std::runtime_error("external sort: input ended early");
+        recordsRead += count;
+        // Queued behind the write of the other chunk, so reuse is safe.
+        if (recordsRead < stats.records) pendingRead = readChunk(1 - active);
+
+        std::vector<T>& chunk = chunks[active];
+        parallelMergeSort(chunk.begin(), chunk.begin() + count, scratch, cmp);
+
+        bool single = runs.empty() && recordsRead == stats.records;
+        std::string path = single ? outputPath : tempPath(prefix, 0, runs.size());
+        runs.push_back(path);
+        if (!single) temps.add(path);
+        // The run is open only while it is written, so the number of runs is
+        // not limited by the number of open files.
+        const T* src = chunk.data();
+        writes.push_back(io.submit([path, src, count] {
+            File f = openFile(path, "wb");
+            writeRecords(f.get(), src, count);
+            if (std::fclose(f.release()) != 0) throw std::runtime_error("external sort: close failed");
+        }));
+
+        formation.update(recordsRead * sizeof(T));
+        active = 1 - active;
+    }
+    for (auto& w : writes) w.get();
+    input.reset();
+    chunks[0] = std::vector<T>();
+    chunks[1] = std::vector<T>();
+    scratch = std::vector<T>();
+    stats.initialRuns = runs.size();
+
+    if (runs.size() <= 1) {
+        if (runs.empty()) openFile(outputPath, "wb");
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    // Phase 2: each run needs two blocks, and the output two more. A budget
+    // too small for a two-way merge of minIoBlockSize blocks (six blocks)
+    // gets smaller blocks instead of going over budget. Each run also holds a
+    // file open; a few descriptors are left for the output, the standard
+    // streams and the caller.
+    constexpr size_t kReservedFiles = 16;
+    size_t minBlockRecords =
+        std::max<size_t>(1, std::min(options.minIoBlockSize, options.memoryBudget / 6) / sizeof(T));
+    size_t blockPairs = options.memoryBudget / (2 * minBlockRecords * sizeof(T));
+    size_t maxFanIn = std::max<size_t>(2, blockPairs > 0 ? blockPairs - 1 : 0);
+    size_t fileLimit = openFileLimit();
+    if (fileLimit != SIZE_MAX) {
+        maxFanIn = std::max<size_t>(2, std::min(maxFanIn, fileLimit - std::min(fileLimit, kReservedFiles)));
+    }
+    size_t pass = 0;
+    while (!runs.empty()) {
+        ++pass;
+        bool last = runs.size() <= maxFanIn;
+        size_t fanIn = last ? runs.size() : maxFanIn;
+        size_t blockRecords = std::max(minBlockRecords,
+                                       std::min(options.ioBlockSize / sizeof(T),
+                                                options.memoryBudget / (2 * (fanIn + 1) * sizeof(T))));
+
+        ProgressReporter merging(options, "merge pass " + std::to_string(pass), bytes);
+        uint64_t recordsDone = 0;
+        std::vector<std::string> nextRuns;
+        for (size_t first = 0; first < runs.size(); first += fanIn) {
+            std::vector<std::string> group(runs.begin() + first,
+                                           runs.begin() + std::min(runs.size(), first + fanIn));
+            std::string out = last ? outputPath : tempPath(prefix, pass, nextRuns.size());
+            if (group.size() == 1 && !last) {
+                nextRuns.push_back(group[0]); // Carried over unchanged
+                continue;
+            }
+            if (!last) temps.add(out);
+            mergeRuns<T>(group, out, blockRecords, cmp, io, merging, recordsDone);
+            for (const auto& path : group) temps.remove(path);
+            nextRuns.push_back(out);
+        }
+        merging.update(bytes);
+        runs = last ? std::vector<std::string>() : std::move(nextRuns);
+    }
+    stats.mergePasses = pass;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
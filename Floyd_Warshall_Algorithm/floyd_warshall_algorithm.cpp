@@ -1,6 +1,11 @@
 #include <iostream>
 #include <vector>
 #include <climits>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "floyd_warshall_algorithm.h"
 using namespace std;
 
 void floydWarshall(vector<vector<int>>& graph) {
@@ -29,6 +34,91 @@ void floydWarshall(vector<vector<int>>& graph) {
     }
 }
 
+// The same algorithm on the shared CSR graph type, with the blocked engine in
+// floyd_warshall_algorithm.h, and one shortest path recovered from it
+void floydWarshall(const CsrGraph<>& graph) {
+    size_t V = graph.numVertices();
+    AlignedMatrix<int32_t> dist = distanceMatrix<int32_t>(graph);
+    AlignedMatrix<uint32_t> via;
+    floydWarshall(dist, via);
+
+    cout << "Shortest distances between every pair of vertices:\n";
+    for (size_t i = 0; i < V; ++i) {
+        for (size_t j = 0; j < V; ++j) {
+            if (dist(i, j) == kFloydWarshallInfinity<int32_t>)
+                cout << "INF ";
+            else
+                cout << dist(i, j) << " ";
+        }
+        cout << endl;
+    }
+    cout << "Path from 3 to 1:";
+    for (uint32_t v : floydWarshallPath(dist, via, 3, 1)) cout << " " << v;
+    cout << endl;
+}
+
+static double since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// A random graph of 2048 vertices: the triple loop of floydWarshall() against
+// the blocked engine with each kernel family
+void benchmark() {
+    const size_t n = 2048, m = n * 16;
+    mt19937_64 rng(21);
+    vector<CsrEdge<uint32_t, int32_t>> edges(m);
+    for (auto& e : edges) e = {uint32_t(rng() % n), uint32_t(rng() % n), int32_t(1 + rng() % 1000)};
+    CsrGraph<> graph = CsrGraph<>::fromEdges(n, edges);
+    cout << "Random graph: " << n << " vertices, " << graph.numEdges() << " edges" << endl;
+
+    vector<vector<int>> dist(n, vector<int>(n, INT_MAX));
+    for (size_t i = 0; i < n; ++i) dist[i][i] = 0;
+    graph.forEachEdge([&](uint32_t u, uint32_t v, int w) { dist[u][v] = min(dist[u][v], w); });
+    auto start = chrono::steady_clock::now();
+    for (size_t k = 0; k < n; ++k) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                if (dist[i][k] != INT_MAX && dist[k][j] != INT_MAX) {
+                    dist[i][j] = min(dist[i][j], dist[i][k] + dist[k][j]);
+                }
+            }
+        }
+    }
+    cout << "  triple loop, vector<vector<int>>: " << since(start) << " ms" << endl;
+
+    auto same = [&](const AlignedMatrix<int32_t>& d) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                int expected = dist[i][j] == INT_MAX ? kFloydWarshallInfinity<int32_t> : dist[i][j];
+                if (d(i, j) != expected) return "no";
+            }
+        }
+        return "yes";
+    };
+    const pair<SimdLevel, const char*> levels[] = {
+        {SimdLevel::Scalar, "scalar"}, {SimdLevel::SSE41, "SSE4.1"}, {SimdLevel::AVX2, "AVX2  "}};
+    for (auto [level, name] : levels) {
+        if (level > detectSimdLevel()) continue;
+        AlignedMatrix<int32_t> d = distanceMatrix<int32_t>(graph);
+        start = chrono::steady_clock::now();
+        floydWarshall(d, level);
+        cout << "  blocked, " << name << ":                 " << since(start) << " ms, same: " << same(d) << endl;
+    }
+    AlignedMatrix<int32_t> d = distanceMatrix<int32_t>(graph);
+    AlignedMatrix<uint32_t> via;
+    start = chrono::steady_clock::now();
+    floydWarshall(d, via);
+    cout << "  blocked, best, with paths:        " << since(start) << " ms, same: " << same(d) << endl;
+    for (size_t threads : {2, 4}) {
+        ThreadPool pool(threads);
+        d = distanceMatrix<int32_t>(graph);
+        start = chrono::steady_clock::now();
+        floydWarshall(d, detectSimdLevel(), pool);
+        cout << "  blocked, best, " << threads << " threads:          " << since(start) << " ms, same: " << same(d)
+             << endl;
+    }
+}
+
 int main() {
     vector<vector<int>> graph = {
         {0, 3, INT_MAX, INT_MAX},
@@ -37,6 +127,10 @@ int main() {
         {6, INT_MAX, INT_MAX, 0}};
 
     floydWarshall(graph);
+    cout << "From the CSR graph:" << endl;
+    floydWarshall(CsrGraph<>::fromAdjacencyMatrix(graph, INT_MAX));
+
+    benchmark();
     return 0;
 }
 
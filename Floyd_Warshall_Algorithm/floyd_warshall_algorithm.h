@@ -0,0 +1,436 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Sorting_Network/sorting_network.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Blocked (tiled) all-pairs shortest paths with Floyd-Warshall on one
+// contiguous, 64-byte aligned matrix of int32_t or float distances.
+//
+// The matrix is split into 64 x 64 tiles; the row stride is padded to a whole
+// number of tiles, with unreachable padding vertices. For every tile index kb,
+// the tiles are updated through the 64 intermediate vertices of block kb in
+// three phases:
+// 1. the diagonal tile (kb, kb), on its own;
+// 2. the other tiles of row kb and column kb, which only need the diagonal
+//    tile, in parallel;
+// 3. all remaining tiles (i, j), which only need (i, kb) and (kb, j), in
+//    parallel.
+// A tile of each kind fits in L1/L2, so a 20000-vertex matrix is streamed
+// through the cache once per tile row instead of once per vertex.
+//
+// Phase 3 is almost all of the work. Its kernel keeps a chunk of a row of
+// C in registers while running over the 64 intermediate vertices, so each step
+// is one broadcast, one load, one add and one min per vector of columns. The
+// sum is saturating: INF plus anything, including a negative weight, stays INF
+// (a compare and blend for int32_t, IEEE infinity for float). Without negative
+// entries a plain add is enough, since INF + d >= INF is never taken by the
+// min, and the blend is left out. A row whose d[i][k] is INF is skipped, so
+// there is no branch per element.
+//
+// As in Sorting_Network/, the AVX2 and SSE4.1 kernels are compiled with target
+// pragmas and picked at runtime, with a scalar fallback.
+//
+// For path recovery, an optional matrix records the intermediate vertex k of
+// the last improvement of every pair, with the same masks. Paths are expanded
+// recursively: i -> k and k -> j were final when i -> j was last improved, so
+// the recursion ends. (Predecessor pointers copied from row k would not do
+// here: in blocked order they can form loops along zero-weight cycles.)
+
+constexpr size_t kFloydWarshallTile = 64;
+constexpr uint32_t kFloydWarshallNone = std::numeric_limits<uint32_t>::max();
+
+// Unreachable. For int32_t it is half the maximum, so INF + INF cannot
+// overflow; finite distances must stay within (-INF, INF).
+template <typename T>
+constexpr T kFloydWarshallInfinity =
+    std::is_floating_point_v<T> ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max() / 2;
+
+// Square matrix of n x n entries with rows padded to a multiple of the tile
+// size and aligned to a cache line.
+template <typename T>
+class AlignedMatrix {
+public:
+    AlignedMatrix() = default;
+
+    AlignedMatrix(size_t n, T fill)
+        : n_(n), stride_((n + kFloydWarshallTile - 1) / kFloydWarshallTile * kFloydWarshallTile),
+          data_(static_cast<T*>(::operator new(std::max<size_t>(1, stride_ * stride_) * sizeof(T),
+                                               std::align_val_t(kAlignment)))) {
+        std::fill(data_.get(), data_.get() + stride_ * stride_, fill);
+    }
+
+    size_t size() const { return n_; }
+    size_t stride() const { return stride_; }
+    T& operator()(size_t i, size_t j) { return data_[i * stride_ + j]; }
+    const T& operator()(size_t i, size_t j) const { return data_[i * stride_ + j]; }
+    T* row(size_t i) { return data_.get() + i * stride_; }
+    const T* row(size_t i) const { return data_.get() + i * stride_; }
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+
+private:
+    static constexpr size_t kAlignment = 64;
+
+    struct Free {
+        void operator()(T* p) const { ::operator delete(p, std::align_val_t(kAlignment)); }
+    };
+
+    size_t n_ = 0;
+    size_t stride_ = 0;
+    std::unique_ptr<T[], Free> data_;
+};
+
+namespace floyd_warshall_detail {
+
+constexpr size_t kTile = kFloydWarshallTile;
+
+template <typename T>
+struct IsFloydWarshallValue
+    : std::integral_constant<bool, std::is_same<T, int32_t>::value || std::is_same<T, float>::value> {};
+
+// Tile kernels over Ops, which supplies kLanes, Vec, Mask, Index, load/store,
+// set1, add, plus (saturating), minv, less, loadIndex/storeIndex, setIndex and
+// selectIndex(mask, a, b) (b where the mask is set). C, A and B point to the
+// top-left entries of their tiles, VC to the via tile at C (or nullptr), and
+// kBase is the first vertex of the intermediate block. Expanded once per
+// target region, like SORTING_NETWORK_BODY.
+//
+// kOuter runs k in the outer loop, so C may be A or B (phases 1 and 2).
+// iOuter holds V vectors of a row of C in registers over all k (phase 3).
+#define FLOYD_WARSHALL_KERNELS(Name, OpsTemplate)                                                  \
+    template <typename T, bool WithVia, bool Saturate>                                             \
+    struct Name {                                                                                  \
+        using Ops = OpsTemplate<T>;                                                                \
+        using Vec = typename Ops::Vec;                                                             \
+        using Index = typename Ops::Index;                                                         \
+        static constexpr size_t W = Ops::kLanes;                                                   \
+        static constexpr size_t V = WithVia ? 4 : 8;                                               \
+        static constexpr T INF = kFloydWarshallInfinity<T>;                                        \
+                                                                                                   \
+        static Vec sum(Vec a, Vec b) { return Saturate ? Ops::plus(a, b) : Ops::add(a, b); }       \
+                                                                                                   \
+        static void kOuter(T* c, const T* a, const T* b, size_t stride, uint32_t* vc,              \
+                           uint32_t kBase) {                                                       \
+            for (size_t k = 0; k < kTile; ++k) {                                                   \
+                const T* bk = b + k * stride;                                                      \
+                Index via = Ops::setIndex(static_cast<uint32_t>(kBase + k));                       \
+                for (size_t i = 0; i < kTile; ++i) {                                               \
+                    T aik = a[i * stride + k];                                                     \
+                    if (aik == INF) continue;                                                      \
+                    Vec x = Ops::set1(aik);                                                        \
+                    T* ci = c + i * stride;                                                        \
+                    for (size_t j = 0; j < kTile; j += W) {                                        \
+                        Vec s = sum(x, Ops::load(bk + j));                                         \
+                        Vec cur = Ops::load(ci + j);                                               \
+                        if constexpr (WithVia) {                                                   \
+                            uint32_t* vci = vc + i * stride + j;                                   \
+                            Ops::storeIndex(vci, Ops::selectIndex(Ops::less(s, cur), Ops::loadIndex(vci), via)); \
+                        }                                                                          \
+                        Ops::store(ci + j, Ops::minv(cur, s));                                     \
+                    }                                                                              \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        static void iOuter(T* c, const T* a, const T* b, size_t stride, uint32_t* vc,              \
+                           uint32_t kBase) {                                                       \
+            for (size_t i = 0; i < kTile; ++i) {                                                   \
+                const T* ai = a + i * stride;                                                      \
+                for (size_t j0 = 0; j0 < kTile; j0 += V * W) {                                     \
+                    T* ci = c + i * stride + j0;                                                   \
+                    Vec r[V];                                                                      \
+                    Index p[WithVia ? V : 1];                                                      \
+                    _Pragma("GCC unroll 8")                                                        \
+                    for (size_t v = 0; v < V; ++v) r[v] = Ops::load(ci + v * W);                   \
+                    if constexpr (WithVia) {                                                       \
+                        _Pragma("GCC unroll 8")                                                    \
+                        for (size_t v = 0; v < V; ++v) p[v] = Ops::loadIndex(vc + i * stride + j0 + v * W); \
+                    }                                                                              \
+                    for (size_t k = 0; k < kTile; ++k) {                                           \
+                        if (ai[k] == INF) continue;                                                \
+                        Vec x = Ops::set1(ai[k]);                                                  \
+                        Index via = Ops::setIndex(static_cast<uint32_t>(kBase + k));               \
+                        const T* bk = b + k * stride + j0;                                         \
+                        _Pragma("GCC unroll 8")                                                    \
+                        for (size_t v = 0; v < V; ++v) {                                           \
+                            Vec s = sum(x, Ops::load(bk + v * W));                                 \
+                            if constexpr (WithVia) p[v] = Ops::selectIndex(Ops::less(s, r[v]), p[v], via); \
+                            r[v] = Ops::minv(r[v], s);                                             \
+                        }                                                                          \
+                    }                                                                              \
+                    _Pragma("GCC unroll 8")                                                        \
+                    for (size_t v = 0; v < V; ++v) Ops::store(ci + v * W, r[v]);                   \
+                    if constexpr (WithVia) {                                                       \
+                        _Pragma("GCC unroll 8")                                                    \
+                        for (size_t v = 0; v < V; ++v) Ops::storeIndex(vc + i * stride + j0 + v * W, p[v]); \
+                    }                                                                              \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+    };
+
+// One lane, branch-free through conditional moves.
+template <typename T>
+struct ScalarOps {
+    static constexpr size_t kLanes = 1;
+    static constexpr T INF = kFloydWarshallInfinity<T>;
+    using Vec = T;
+    using Mask = bool;
+    using Index = uint32_t;
+    static Vec load(const T* p) { return *p; }
+    static void store(T* p, Vec v) { *p = v; }
+    static Vec set1(T x) { return x; }
+    static Vec add(Vec a, Vec b) { return a + b; }
+    static Vec plus(Vec a, Vec b) {
+        if constexpr (std::is_floating_point_v<T>) return a + b;
+        else return b == INF ? INF : a + b;
+    }
+    static Vec minv(Vec a, Vec b) { return b < a ? b : a; }
+    static Mask less(Vec a, Vec b) { return a < b; }
+    static Index loadIndex(const uint32_t* p) { return *p; }
+    static void storeIndex(uint32_t* p, Index v) { *p = v; }
+    static Index setIndex(uint32_t x) { return x; }
+    static Index selectIndex(Mask m, Index a, Index b) { return m ? b : a; }
+};
+
+FLOYD_WARSHALL_KERNELS(ScalarKernels, ScalarOps)
+
+#ifdef SORTING_NETWORK_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+
+template <typename T>
+struct Sse41Ops;
+
+template <>
+struct Sse41Ops<int32_t> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m128i;
+    using Mask = __m128i;
+    using Index = __m128i;
+    static Vec load(const int32_t* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(int32_t* p, Vec v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec set1(int32_t x) { return _mm_set1_epi32(x); }
+    static Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+    static Vec plus(Vec a, Vec b) {
+        Vec inf = _mm_set1_epi32(kFloydWarshallInfinity<int32_t>);
+        return _mm_blendv_epi8(_mm_add_epi32(a, b), inf, _mm_cmpeq_epi32(b, inf));
+    }
+    static Vec minv(Vec a, Vec b) { return _mm_min_epi32(a, b); }
+    static Mask less(Vec a, Vec b) { return _mm_cmplt_epi32(a, b); }
+    static Index loadIndex(const uint32_t* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void storeIndex(uint32_t* p, Index v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Index setIndex(uint32_t x) { return _mm_set1_epi32(static_cast<int32_t>(x)); }
+    static Index selectIndex(Mask m, Index a, Index b) { return _mm_blendv_epi8(a, b, m); }
+};
+
+template <>
+struct Sse41Ops<float> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m128;
+    using Mask = __m128;
+    using Index = __m128i;
+    static Vec load(const float* p) { return _mm_load_ps(p); }
+    static void store(float* p, Vec v) { _mm_store_ps(p, v); }
+    static Vec set1(float x) { return _mm_set1_ps(x); }
+    static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static Vec plus(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static Vec minv(Vec a, Vec b) { return _mm_min_ps(a, b); }
+    static Mask less(Vec a, Vec b) { return _mm_cmplt_ps(a, b); }
+    static Index loadIndex(const uint32_t* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void storeIndex(uint32_t* p, Index v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Index setIndex(uint32_t x) { return _mm_set1_epi32(static_cast<int32_t>(x)); }
+    static Index selectIndex(Mask m, Index a, Index b) { return _mm_blendv_epi8(a, b, _mm_castps_si128(m)); }
+};
+
+FLOYD_WARSHALL_KERNELS(Sse41Kernels, Sse41Ops)
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+template <typename T>
+struct Avx2Ops;
+
+template <>
+struct Avx2Ops<int32_t> {
+    static constexpr size_t kLanes = 8;
+    using Vec = __m256i;
+    using Mask = __m256i;
+    using Index = __m256i;
+    static Vec load(const int32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int32_t* p, Vec v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Vec set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+    static Vec plus(Vec a, Vec b) {
+        Vec inf = _mm256_set1_epi32(kFloydWarshallInfinity<int32_t>);
+        return _mm256_blendv_epi8(_mm256_add_epi32(a, b), inf, _mm256_cmpeq_epi32(b, inf));
+    }
+    static Vec minv(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+    static Mask less(Vec a, Vec b) { return _mm256_cmpgt_epi32(b, a); }
+    static Index loadIndex(const uint32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void storeIndex(uint32_t* p, Index v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Index setIndex(uint32_t x) { return _mm256_set1_epi32(static_cast<int32_t>(x)); }
+    static Index selectIndex(Mask m, Index a, Index b) { return _mm256_blendv_epi8(a, b, m); }
+};
+
+template <>
+struct Avx2Ops<float> {
+    static constexpr size_t kLanes = 8;
+    using Vec = __m256;
+    using Mask = __m256;
+    using Index = __m256i;
+    static Vec load(const float* p) { return _mm256_load_ps(p); }
+    static void store(float* p, Vec v) { _mm256_store_ps(p, v); }
+    static Vec set1(float x) { return _mm256_set1_ps(x); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec plus(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec minv(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    static Mask less(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Index loadIndex(const uint32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void storeIndex(uint32_t* p, Index v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Index setIndex(uint32_t x) { return _mm256_set1_epi32(static_cast<int32_t>(x)); }
+    static Index selectIndex(Mask m, Index a, Index b) { return _mm256_blendv_epi8(a, b, _mm256_castps_si256(m)); }
+};
+
+FLOYD_WARSHALL_KERNELS(Avx2Kernels, Avx2Ops)
+
+#pragma GCC pop_options
+
+#endif // SORTING_NETWORK_X86
+
+#undef FLOYD_WARSHALL_KERNELS
+
+template <typename T>
+using TileKernel = void (*)(T*, const T*, const T*, size_t, uint32_t*, uint32_t);
+
+template <typename T>
+struct Kernels {
+    TileKernel<T> kOuter;
+    TileKernel<T> iOuter;
+};
+
+template <typename T, bool WithVia, bool Saturate>
+Kernels<T> kernels(SimdLevel level) {
+#ifdef SORTING_NETWORK_X86
+    using Avx2 = Avx2Kernels<T, WithVia, Saturate>;
+    using Sse41 = Sse41Kernels<T, WithVia, Saturate>;
+    if (level == SimdLevel::AVX2) return {Avx2::kOuter, Avx2::iOuter};
+    if (level == SimdLevel::SSE41) return {Sse41::kOuter, Sse41::iOuter};
+#endif
+    (void)level;
+    using Scalar = ScalarKernels<T, WithVia, Saturate>;
+    return {Scalar::kOuter, Scalar::iOuter};
+}
+
+// Whether any entry is negative; only then does an integer sum need to
+// saturate.
+template <typename T>
+bool hasNegative(const AlignedMatrix<T>& dist) {
+    if constexpr (std::is_floating_point_v<T>) return false;
+    const T* d = dist.data();
+    return std::any_of(d, d + dist.stride() * dist.stride(), [](T x) { return x < 0; });
+}
+
+template <typename T, bool WithVia>
+void run(AlignedMatrix<T>& dist, uint32_t* via, SimdLevel level, ThreadPool& pool) {
+    Kernels<T> kernel = hasNegative(dist) ? kernels<T, WithVia, true>(level) : kernels<T, WithVia, false>(level);
+    size_t stride = dist.stride();
+    size_t blocks = stride / kTile;
+    T* d = dist.data();
+    auto at = [&](size_t bi, size_t bj) { return d + (bi * stride + bj) * kTile; };
+    auto viaAt = [&](size_t bi, size_t bj) -> uint32_t* { return WithVia ? via + (bi * stride + bj) * kTile : nullptr; };
+    for (size_t kb = 0; kb < blocks; ++kb) {
+        uint32_t kBase = static_cast<uint32_t>(kb * kTile);
+        // Phase 1: the diagonal tile
+        kernel.kOuter(at(kb, kb), at(kb, kb), at(kb, kb), stride, viaAt(kb, kb), kBase);
+        if (blocks == 1) break;
+        // Phase 2: row kb and column kb
+        size_t others = blocks - 1;
+        pool.parallelFor(2 * others, [&](size_t t) {
+            size_t b = t % others;
+            b += b >= kb;
+            if (t < others) {
+                kernel.kOuter(at(kb, b), at(kb, kb), at(kb, b), stride, viaAt(kb, b), kBase);
+            } else {
+                kernel.kOuter(at(b, kb), at(b, kb), at(kb, kb), stride, viaAt(b, kb), kBase);
+            }
+        });
+        // Phase 3: everything else
+        pool.parallelFor(others * others, [&](size_t t) {
+            size_t bi = t / others, bj = t % others;
+            bi += bi >= kb;
+            bj += bj >= kb;
+            kernel.iOuter(at(bi, bj), at(bi, kb), at(kb, bj), stride, viaAt(bi, bj), kBase);
+        });
+    }
+}
+
+} // namespace floyd_warshall_detail
+
+// Distance matrix of a graph: the lightest edge for each pair, 0 on the
+// diagonal (or a negative self-loop) and kFloydWarshallInfinity elsewhere.
+template <typename T, typename Id, typename Weight>
+AlignedMatrix<T> distanceMatrix(const CsrGraph<Id, Weight>& graph) {
+    static_assert(floyd_warshall_detail::IsFloydWarshallValue<T>::value, "int32_t or float distances only");
+    size_t n = graph.numVertices();
+    AlignedMatrix<T> dist(n, kFloydWarshallInfinity<T>);
+    for (size_t i = 0; i < n; ++i) dist(i, i) = 0;
+    graph.forEachEdge([&](Id u, Id v, Weight w) { dist(u, v) = std::min(dist(u, v), static_cast<T>(w)); });
+    return dist;
+}
+
+// All-pairs shortest distances, in place. With a negative cycle, some
+// dist(i, i) end up negative and the other entries are meaningless.
+template <typename T>
+void floydWarshall(AlignedMatrix<T>& dist, SimdLevel level = detectSimdLevel(),
+                   ThreadPool& pool = defaultThreadPool()) {
+    static_assert(floyd_warshall_detail::IsFloydWarshallValue<T>::value, "int32_t or float distances only");
+    floyd_warshall_detail::run<T, false>(dist, nullptr, level, pool);
+}
+
+// As above, and fills via: via(i, j) is an intermediate vertex of a shortest
+// path from i to j, or kFloydWarshallNone for a direct edge (and for i == j).
+template <typename T>
+void floydWarshall(AlignedMatrix<T>& dist, AlignedMatrix<uint32_t>& via, SimdLevel level = detectSimdLevel(),
+                   ThreadPool& pool = defaultThreadPool()) {
+    static_assert(floyd_warshall_detail::IsFloydWarshallValue<T>::value, "int32_t or float distances only");
+    via = AlignedMatrix<uint32_t>(dist.size(), kFloydWarshallNone);
+    floyd_warshall_detail::run<T, true>(dist, via.data(), level, pool);
+}
+
+// Vertices of a shortest path from i to j, both included, from the matrices
+// of floydWarshall(dist, via); empty if j is unreachable from i.
+template <typename T>
+std::vector<uint32_t> floydWarshallPath(const AlignedMatrix<T>& dist, const AlignedMatrix<uint32_t>& via, uint32_t i,
+                                        uint32_t j) {
+    std::vector<uint32_t> path;
+    if (dist(i, j) == kFloydWarshallInfinity<T>) return path;
+    path.push_back(i);
+    std::vector<std::pair<uint32_t, uint32_t>> pending{{i, j}}; // Segments still to expand, last one first
+    while (!pending.empty()) {
+        auto [from, to] = pending.back();
+        pending.pop_back();
+        if (from == to) continue;
+        uint32_t k = via(from, to);
+        if (k == kFloydWarshallNone) {
+            path.push_back(to);
+        } else {
+            pending.push_back({k, to});
+            pending.push_back({from, k});
+        }
+    }
+    return path;
+}
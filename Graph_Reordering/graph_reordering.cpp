@@ -0,0 +1,114 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include "../CSR_Graph/csr_graph.h"
+#include "../Breadth_First_Search/breadth_first_search.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "../Minimum_Spanning_Tree/minimum_spanning_tree.h"
+#include "graph_reordering.h"
+using namespace std;
+
+// Average distance between the ids of the two ends of an edge
+double averageGap(const CsrGraph<>& graph) {
+    double sum = 0;
+    graph.forEachEdge([&](uint32_t u, uint32_t v, int32_t) { sum += u > v ? u - v : v - u; });
+    return sum / max<uint64_t>(graph.numEdges(), 1);
+}
+
+// Runs BFS, Dijkstra and Prim on every order of a graph whose input ids are
+// shuffled, and checks that the distances translated back are the same.
+void compareOrders(const CsrGraph<>& graph, uint32_t source) {
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    vector<int64_t> expected = dijkstra(graph, source).distance;
+    struct Candidate {
+        string name;
+        bool reorder;
+        VertexOrder order;
+    };
+    for (const Candidate& c : {Candidate{"input order ", false, VertexOrder::Degree},
+                               Candidate{"degree      ", true, VertexOrder::Degree},
+                               Candidate{"RCM         ", true, VertexOrder::ReverseCuthillMcKee},
+                               Candidate{"community   ", true, VertexOrder::Community}}) {
+        ReorderedGraph<uint32_t, int32_t> r;
+        double reorderMs = 0;
+        if (c.reorder) {
+            auto start = chrono::steady_clock::now();
+            r = reorder(graph, c.order);
+            reorderMs = since(start);
+        } else {
+            r.graph = graph;
+            r.newId.resize(graph.numVertices());
+            for (size_t v = 0; v < r.newId.size(); ++v) r.newId[v] = uint32_t(v);
+            r.oldId = r.newId;
+        }
+        uint32_t s = r.newId[source];
+        auto start = chrono::steady_clock::now();
+        parallelBfs(r.graph, s);
+        double bfsMs = since(start);
+        start = chrono::steady_clock::now();
+        vector<int64_t> distance = dijkstra(r.graph, s).distance;
+        double dijkstraMs = since(start);
+        start = chrono::steady_clock::now();
+        primMst(r.graph);
+        double primMs = since(start);
+        cout << "  " << c.name << "gap " << averageGap(r.graph) << ", reorder " << reorderMs << " ms, BFS " << bfsMs
+             << " ms, Dijkstra " << dijkstraMs << " ms, Prim " << primMs << " ms, same distances: "
+             << (toOriginalOrder(distance, r.newId) == expected ? "yes" : "no") << endl;
+    }
+}
+
+int main() {
+    // A small path 0 - 2 - 4 - 1 - 3 with scattered ids
+    vector<pair<uint32_t, uint32_t>> path = {{0, 2}, {2, 4}, {4, 1}, {1, 3}};
+    CsrBuildOptions undirected;
+    undirected.symmetrize = true;
+    ReorderedGraph<uint32_t, int32_t> small =
+        reorder(CsrGraph<>::fromEdges(5, path, undirected), VertexOrder::ReverseCuthillMcKee);
+    cout << "RCM new ids of 0..4:";
+    for (uint32_t x : small.newId) cout << " " << x;
+    cout << endl;
+
+    mt19937_64 rng(41);
+    const size_t side = 1000, n = side * side;
+    vector<uint32_t> shuffled(n);
+    for (size_t v = 0; v < n; ++v) shuffled[v] = uint32_t(v);
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    // The road-like grid of the Dijkstra demo, with ids in random order
+    vector<CsrEdge<uint32_t, int32_t>> edges;
+    for (size_t r = 0; r < side; ++r) {
+        for (size_t c = 0; c < side; ++c) {
+            uint32_t v = shuffled[r * side + c];
+            if (c + 1 < side) edges.push_back({v, shuffled[r * side + c + 1], int32_t(1 + rng() % 100)});
+            if (r + 1 < side) edges.push_back({v, shuffled[(r + 1) * side + c], int32_t(1 + rng() % 100)});
+        }
+    }
+    CsrGraph<> grid = CsrGraph<>::fromEdges(n, edges, undirected);
+    cout << "Shuffled road grid: " << grid.numVertices() << " vertices, " << grid.numEdges() << " edges" << endl;
+    compareOrders(grid, shuffled[0]);
+
+    // Communities of 1000 vertices: 15 edges per vertex inside its own, 1 to
+    // a random vertex anywhere, with ids in random order
+    edges.clear();
+    for (size_t v = 0; v < n; ++v) {
+        size_t base = v / 1000 * 1000;
+        for (int k = 0; k < 15; ++k) {
+            edges.push_back({shuffled[v], shuffled[base + rng() % 1000], int32_t(1 + rng() % 100)});
+        }
+        edges.push_back({shuffled[v], shuffled[rng() % n], int32_t(1 + rng() % 100)});
+    }
+    CsrBuildOptions simple = undirected;
+    simple.dropSelfLoops = true;
+    CsrGraph<> social = CsrGraph<>::fromEdges(n, edges, simple);
+    cout << "Shuffled community graph: " << social.numVertices() << " vertices, " << social.numEdges() << " edges"
+         << endl;
+    compareOrders(social, shuffled[0]);
+    return 0;
+}
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Radix_Sort/radix_sort.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Vertex reordering of a CsrGraph for cache locality.
+//
+// A traversal reads the neighbor list of each vertex it visits and then the
+// per-vertex arrays (distances, parents, visited flags) at the neighbors'
+// ids. If ids follow the input order, those reads are scattered over memory.
+// Giving vertices that are visited together nearby ids turns them into reads
+// of the same or adjacent cache lines.
+//
+// - Degree: vertices by decreasing degree. The hubs, which almost every
+//   traversal touches, share a few cache lines at the front.
+// - ReverseCuthillMcKee: breadth-first order from a pseudo-peripheral vertex
+//   (found by repeated BFS, as in George and Liu), with the neighbors of
+//   each vertex taken by increasing degree, then reversed. It minimizes the
+//   bandwidth, so neighbors have nearby ids, which suits meshes and road
+//   networks.
+// - Community: the incremental aggregation of Rabbit Order (Arai et al.).
+//   Vertices, by increasing degree, are merged into the neighboring
+//   community with the largest modularity gain, if it is positive; their
+//   edges are aggregated into that community's. A depth-first walk of the
+//   resulting dendrogram then numbers every community, at every level, with
+//   consecutive ids. It suits graphs with community structure, such as
+//   social and web graphs.
+//
+// The orders are computed on the out-edges; RCM and Community are meant for
+// undirected graphs that store every edge in both directions.
+
+enum class VertexOrder { Degree, ReverseCuthillMcKee, Community };
+
+template <typename Id, typename Weight>
+struct ReorderedGraph {
+    CsrGraph<Id, Weight> graph;
+    std::vector<Id> newId; // newId[v]: the id of input vertex v in graph
+    std::vector<Id> oldId; // oldId[x]: the input vertex that has id x in graph
+};
+
+namespace graph_reordering_detail {
+
+// Vertices by increasing degree, ties by id.
+template <typename Id, typename Weight>
+std::vector<Id> byDegree(const CsrGraph<Id, Weight>& graph, ThreadPool& pool) {
+    std::vector<Id> vertices(graph.numVertices());
+    for (size_t v = 0; v < vertices.size(); ++v) vertices[v] = static_cast<Id>(v);
+    parallelRadixSort(vertices.begin(), vertices.end(), [&](Id v) { return graph.degree(v); }, pool);
+    return vertices;
+}
+
+// Breadth-first search over the vertices not yet placed, reusing its arrays:
+// stamp[v] == round marks the vertices reached in the current search.
+// Returns the vertices in BFS order; levelOf(v) is the BFS level of each.
+template <typename Id, typename Weight>
+class LevelSearch {
+public:
+    explicit LevelSearch(const CsrGraph<Id, Weight>& graph)
+        : graph(graph), stamp(graph.numVertices(), 0), level(graph.numVertices()) {}
+
+    const std::vector<Id>& run(Id source, const std::vector<bool>& placed) {
+        ++round;
+        order.clear();
+        order.push_back(source);
+        stamp[source] = round;
+        level[source] = 0;
+        for (size_t head = 0; head < order.size(); ++head) {
+            Id u = order[head];
+            for (Id v : graph.neighbors(u)) {
+                if (stamp[v] == round || placed[v]) continue;
+                stamp[v] = round;
+                level[v] = level[u] + 1;
+                order.push_back(v);
+            }
+        }
+        return order;
+    }
+
+    size_t levelOf(Id v) const { return level[v]; }
+
+private:
+    const CsrGraph<Id, Weight>& graph;
+    std::vector<uint64_t> stamp;
+    std::vector<size_t> level;
+    std::vector<Id> order;
+    uint64_t round = 0;
+};
+
+// George-Liu: BFS from start, move to a vertex of smallest degree on the
+// last level, and repeat while the depth grows.
+template <typename Id, typename Weight>
+Id pseudoPeripheral(const CsrGraph<Id, Weight>& graph, LevelSearch<Id, Weight>& search,
+                    const std::vector<bool>& placed, Id start) {
+    constexpr int kMaxSearches = 8;
+    size_t depth = 0;
+    for (int i = 0; i < kMaxSearches; ++i) {
+        const std::vector<Id>& order = search.run(start, placed);
+        size_t last = search.levelOf(order.back());
+        if (i > 0 && last <= depth) break;
+        depth = last;
+        Id next = order.back();
+        for (size_t j = order.size(); j-- > 0 && search.levelOf(order[j]) == last;) {
+            if (graph.degree(order[j]) < graph.degree(next)) next = order[j];
+        }
+        start = next;
+    }
+    return start;
+}
+
+template <typename Id, typename Weight>
+std::vector<Id> reverseCuthillMcKee(const CsrGraph<Id, Weight>& graph, ThreadPool& pool) {
+    size_t n = graph.numVertices();
+    LevelSearch<Id, Weight> search(graph);
+    std::vector<bool> placed(n, false);
+    std::vector<Id> order, batch;
+    order.reserve(n);
+    for (Id s : byDegree(graph, pool)) {
+        // In a directed graph, the start found from s need not reach s
+        while (!placed[s]) {
+            Id start = pseudoPeripheral(graph, search, placed, s);
+            placed[start] = true;
+            order.push_back(start);
+            for (size_t head = order.size() - 1; head < order.size(); ++head) {
+                batch.clear();
+                for (Id v : graph.neighbors(order[head])) {
+                    if (!placed[v]) {
+                        placed[v] = true;
+                        batch.push_back(v);
+                    }
+                }
+                std::sort(batch.begin(), batch.end(), [&](Id a, Id b) {
+                    return graph.degree(a) < graph.degree(b) || (graph.degree(a) == graph.degree(b) && a < b);
+                });
+                order.insert(order.end(), batch.begin(), batch.end());
+            }
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+template <typename Id, typename Weight>
+std::vector<Id> communityOrder(const CsrGraph<Id, Weight>& graph, ThreadPool& pool) {
+    size_t n = graph.numVertices();
+    double total = static_cast<double>(std::max<uint64_t>(graph.numEdges(), 1)); // 2m for an undirected graph
+    std::vector<Id> dest(n);                     // Community a vertex was merged into, or itself
+    std::vector<double> strength(n);             // Total degree of the community
+    std::vector<std::vector<std::pair<Id, double>>> merged(n); // Edges of the vertices merged into v
+    std::vector<bool> done(n, false);
+    std::vector<Id> firstChild(n, static_cast<Id>(n)), nextSibling(n, static_cast<Id>(n));
+    for (size_t v = 0; v < n; ++v) {
+        dest[v] = static_cast<Id>(v);
+        strength[v] = static_cast<double>(graph.degree(static_cast<Id>(v)));
+    }
+    auto community = [&](Id v) {
+        while (dest[v] != v) {
+            dest[v] = dest[dest[v]]; // Path halving
+            v = dest[v];
+        }
+        return v;
+    };
+
+    std::vector<double> weightTo(n, 0.0);
+    std::vector<Id> touched;
+    std::vector<std::pair<Id, double>> edges;
+    for (Id u : byDegree(graph, pool)) {
+        // The edges of u and of everything merged into it, by community
+        touched.clear();
+        auto add = [&](Id v, double w) {
+            Id c = community(v);
+            if (c == u) return;
+            if (weightTo[c] == 0.0) touched.push_back(c);
+            weightTo[c] += w;
+        };
+        for (Id v : graph.neighbors(u)) add(v, 1.0);
+        for (const auto& [v, w] : merged[u]) add(v, w);
+        edges.clear();
+        Id best = u;
+        double bestGain = 0.0;
+        for (Id c : touched) {
+            double gain = weightTo[c] - strength[u] * strength[c] / total;
+            if (gain > bestGain || (gain == bestGain && best != u && c < best)) {
+                best = c;
+                bestGain = gain;
+            }
+            edges.emplace_back(c, weightTo[c]);
+            weightTo[c] = 0.0;
+        }
+        std::vector<std::pair<Id, double>>().swap(merged[u]);
+        done[u] = true;
+        if (best == u) continue;
+
+        dest[u] = best;
+        strength[best] += strength[u];
+        nextSibling[u] = firstChild[best];
+        firstChild[best] = u;
+        // A community that was already processed never reads its edges again
+        if (!done[best]) merged[best].insert(merged[best].end(), edges.begin(), edges.end());
+    }
+
+    // Depth-first walk of the dendrogram from every top-level community
+    std::vector<Id> order, stack;
+    order.reserve(n);
+    for (size_t root = 0; root < n; ++root) {
+        if (dest[root] != root) continue;
+        stack.push_back(static_cast<Id>(root));
+        while (!stack.empty()) {
+            Id v = stack.back();
+            stack.pop_back();
+            order.push_back(v);
+            for (Id c = firstChild[v]; c != n; c = nextSibling[c]) stack.push_back(c);
+        }
+    }
+    return order;
+}
+
+} // namespace graph_reordering_detail
+
+// The inverse of a permutation of 0..n-1. Throws std::invalid_argument if it
+// is not one.
+template <typename Id>
+std::vector<Id> inversePermutation(const std::vector<Id>& permutation) {
+    std::vector<Id> inverse(permutation.size(), static_cast<Id>(permutation.size()));
+    for (size_t v = 0; v < permutation.size(); ++v) {
+        Id x = permutation[v];
+        if (x >= permutation.size() || inverse[x] != permutation.size()) {
+            throw std::invalid_argument("graph reordering: not a permutation");
+        }
+        inverse[x] = static_cast<Id>(v);
+    }
+    return inverse;
+}
+
+// The new id of every vertex (a permutation) for the given order.
+template <typename Id, typename Weight>
+std::vector<Id> vertexOrder(const CsrGraph<Id, Weight>& graph, VertexOrder order,
+                            ThreadPool& pool = defaultThreadPool()) {
+    std::vector<Id> sequence; // Input vertices in their new order
+    switch (order) {
+    case VertexOrder::Degree:
+        sequence.resize(graph.numVertices());
+        for (size_t v = 0; v < sequence.size(); ++v) sequence[v] = static_cast<Id>(v);
+        parallelRadixSort(sequence.begin(), sequence.end(), [&](Id v) { return ~graph.degree(v); }, pool);
+        break;
+    case VertexOrder::ReverseCuthillMcKee:
+        sequence = graph_reordering_detail::reverseCuthillMcKee(graph, pool);
+        break;
+    case VertexOrder::Community:
+        sequence = graph_reordering_detail::communityOrder(graph, pool);
+        break;
+    }
+    return inversePermutation(sequence);
+}
+
+// The graph with vertex v renamed to newId[v]. Every neighbor list is sorted
+// by new id. Throws std::invalid_argument if newId is not a permutation of
+// the vertices.
+template <typename Id, typename Weight>
+CsrGraph<Id, Weight> relabel(const CsrGraph<Id, Weight>& graph, const std::vector<Id>& newId,
+                             ThreadPool& pool = defaultThreadPool()) {
+    size_t n = graph.numVertices();
+    if (newId.size() != n) throw std::invalid_argument("graph reordering: permutation size does not match");
+    std::vector<Id> oldId = inversePermutation(newId);
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (size_t x = 0; x < n; ++x) offsets[x + 1] = offsets[x] + graph.degree(oldId[x]);
+    std::vector<Id> targets(graph.numEdges());
+    std::vector<Weight> weights(graph.weighted() ? graph.numEdges() : 0);
+
+    constexpr size_t kGrain = 1024;
+    std::atomic<size_t> next{0};
+    pool.parallelFor(pool.size(), [&](size_t) {
+        std::vector<std::pair<Id, Weight>> list;
+        for (size_t first; (first = next.fetch_add(kGrain, std::memory_order_relaxed)) < n;) {
+            for (size_t x = first; x < std::min(n, first + kGrain); ++x) {
+                Id u = oldId[x];
+                uint64_t at = offsets[x];
+                if (!graph.weighted()) {
+                    for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) targets[at++] = newId[graph.target(e)];
+                    std::sort(targets.begin() + offsets[x], targets.begin() + offsets[x + 1]);
+                    continue;
+                }
+                list.clear();
+                for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+                    list.emplace_back(newId[graph.target(e)], graph.weight(e));
+                }
+                std::sort(list.begin(), list.end());
+                for (const auto& [v, w] : list) {
+                    targets[at] = v;
+                    weights[at++] = w;
+                }
+            }
+        }
+    });
+    return CsrGraph<Id, Weight>(std::move(offsets), std::move(targets), std::move(weights));
+}
+
+// Computes the order and relabels the graph.
+template <typename Id, typename Weight>
+ReorderedGraph<Id, Weight> reorder(const CsrGraph<Id, Weight>& graph, VertexOrder order,
+                                   ThreadPool& pool = defaultThreadPool()) {
+    ReorderedGraph<Id, Weight> result;
+    result.newId = vertexOrder(graph, order, pool);
+    result.oldId = inversePermutation(result.newId);
+    result.graph = relabel(graph, result.newId, pool);
+    return result;
+}
+
+// A per-vertex result computed on the reordered graph (indexed by new id),
+// indexed by input vertex again. Values that are vertex ids, like parents,
+// still need oldId[value].
+template <typename T, typename Id>
+std::vector<T> toOriginalOrder(const std::vector<T>& byNewId, const std::vector<Id>& newId) {
+    std::vector<T> result(newId.size());
+    for (size_t v = 0; v < newId.size(); ++v) result[v] = byNewId[newId[v]];
+    return result;
+}
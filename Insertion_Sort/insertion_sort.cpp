@@ -1,5 +1,7 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include "insertion_sort.h"
 using namespace std;
 
 void insertionSort(vector<int>& arr) {
@@ -25,6 +27,13 @@ int main() {
     insertionSort(arr);
     cout << "Sorted array: ";
     printArray(arr);
+
+    // Generic version from insertion_sort.h, any element type and ordering
+    vector<string> words = {"pear", "apple", "fig", "banana"};
+    insertionSort(words.begin(), words.end(), greater<>());
+    cout << "Words, descending: ";
+    for (const auto& w : words) cout << w << " ";
+    cout << endl;
     return 0;
 }
 
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+// Generic insertion sort, stable. Also the default leaf sort that the merge
+// and quick sort engines call on small subarrays.
+template <typename RandomIt, typename Compare = std::less<>>
+void insertionSort(RandomIt first, RandomIt last, Compare cmp = Compare()) {
+    if (first == last) return;
+    for (RandomIt i = first + 1; i < last; ++i) {
+        auto key = std::move(*i);
+        RandomIt j = i;
+        while (j > first && cmp(key, *(j - 1))) {
+            *j = std::move(*(j - 1));
+            --j;
+        }
+        *j = std::move(key);
+    }
+}
+
+// Leaf sort policy: sorts [lo, hi), which holds at most kMaxLeafSize elements.
+// Other policies (see Sorting_Network/) plug into the same slot.
+struct InsertionLeafSort {
+    static constexpr size_t kMaxLeafSize = 32;
+
+    template <typename T, typename Compare>
+    static void sort(T* lo, T* hi, Compare& cmp) {
+        insertionSort(lo, hi, std::ref(cmp));
+    }
+};
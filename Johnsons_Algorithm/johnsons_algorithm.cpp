@@ -0,0 +1,102 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "../Floyd_Warshall_Algorithm/floyd_warshall_algorithm.h"
+#include "johnsons_algorithm.h"
+using namespace std;
+
+static double since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    // The example graph of the Bellman-Ford module, with negative weights
+    vector<CsrEdge<uint32_t, int32_t>> small = {
+        {0, 1, -1}, {0, 2, 4}, {1, 2, 3}, {1, 3, 2}, {1, 4, 2},
+        {3, 2, 5}, {3, 1, 1}, {4, 3, -3}};
+    vector<vector<int64_t>> matrix(5);
+    johnson(CsrGraph<>::fromEdges(5, small), [&](uint32_t source, const vector<int64_t>& row) {
+        matrix[source] = row; // Rows arrive in any order
+    });
+    cout << "Shortest distances between every pair of vertices:" << endl;
+    for (const auto& row : matrix) {
+        for (int64_t d : row) {
+            if (d == kDijkstraInfinity<int64_t>)
+                cout << "INF ";
+            else
+                cout << d << " ";
+        }
+        cout << endl;
+    }
+
+    // A sparse random graph with average degree 8 and negative weights
+    // w(u, v) + p(u) - p(v), without negative cycles
+    const size_t n = 4096, m = n * 8;
+    mt19937_64 rng(22);
+    vector<int32_t> potential(n);
+    for (int32_t& p : potential) p = int32_t(rng() % 1000);
+    vector<CsrEdge<uint32_t, int32_t>> edges(m);
+    for (auto& e : edges) {
+        e.source = uint32_t(rng() % n);
+        e.target = uint32_t(rng() % n);
+        e.weight = int32_t(1 + rng() % 1000) + potential[e.source] - potential[e.target];
+    }
+    CsrGraph<> graph = CsrGraph<>::fromEdges(n, edges);
+    cout << "Sparse graph: " << n << " vertices, " << graph.numEdges() << " edges" << endl;
+
+    auto start = chrono::steady_clock::now();
+    AlignedMatrix<int32_t> dist = distanceMatrix<int32_t>(graph);
+    floydWarshall(dist);
+    cout << "  Floyd-Warshall (blocked, AVX2): " << since(start) << " ms, "
+         << n * dist.stride() * sizeof(int32_t) / (1 << 20) << " MB matrix" << endl;
+
+    // Compares every row against Floyd-Warshall; rows come from several threads
+    auto check = [&](bool& same, mutex& lock) {
+        return [&](uint32_t source, const vector<int64_t>& row) {
+            bool ok = true;
+            for (size_t v = 0; v < n; ++v) {
+                int64_t expected = dist(source, v) == kFloydWarshallInfinity<int32_t> ? kDijkstraInfinity<int64_t>
+                                                                                     : dist(source, v);
+                ok = ok && row[v] == expected;
+            }
+            lock_guard<mutex> guard(lock);
+            same = same && ok;
+        };
+    };
+    for (DijkstraQueue queue : {DijkstraQueue::DaryHeap, DijkstraQueue::RadixHeap}) {
+        for (size_t threads : {1, 2}) {
+            JohnsonOptions options;
+            options.search.queue = queue;
+            ThreadPool pool(threads);
+            bool same = true;
+            mutex lock;
+            start = chrono::steady_clock::now();
+            johnson(graph, check(same, lock), options, pool);
+            cout << "  Johnson, " << (queue == DijkstraQueue::DaryHeap ? "4-ary heap" : "radix heap") << ", "
+                 << threads << " thread" << (threads > 1 ? "s: " : ":  ") << since(start)
+                 << " ms, same: " << (same ? "yes" : "no") << endl;
+        }
+    }
+
+    const string path = "johnsons_algorithm_demo.bin";
+    start = chrono::steady_clock::now();
+    johnsonToFile(graph, path);
+    double written = since(start);
+    DistanceRowFile<int64_t> rows = DistanceRowFile<int64_t>::map(path);
+    bool same = true;
+    for (size_t s = 0; s < n; s += 97) {
+        for (size_t v = 0; v < n; ++v) {
+            int64_t expected = dist(s, v) == kFloydWarshallInfinity<int32_t> ? kDijkstraInfinity<int64_t> : dist(s, v);
+            same = same && rows.distance(s, v) == expected;
+        }
+    }
+    cout << "  Johnson to file: " << written << " ms, " << rows.numVertices() << " rows mapped, sampled rows same: "
+         << (same ? "yes" : "no") << endl;
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../Bellman_Ford_Algorithm/bellman_ford_algorithm.h"
+#include "../CSR_Graph/csr_graph.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// All-pairs shortest paths on sparse graphs with Johnson's algorithm.
+//
+// 1. Reweighting: Bellman-Ford (SPFA) from a virtual source with a 0-weight
+//    edge to every vertex gives a potential h(v) <= 0. Every edge gets the
+//    weight w(u, v) + h(u) - h(v), which is non-negative, and every path from
+//    s to t changes by the same h(s) - h(t), so shortest paths stay shortest.
+//    A negative cycle makes this impossible and is reported before any row.
+//    Without negative weights this step is skipped.
+// 2. One Dijkstra per source on the reweighted graph, on all threads of the
+//    pool. Each worker owns one DijkstraSearch and one row buffer and claims
+//    sources one at a time.
+//
+// Rows are handed to a callback as soon as they are done, or written straight
+// to their place in a file, so memory stays at O(V) per worker instead of V^2.
+// The total time is O(V E log V), against V^3 for Floyd-Warshall.
+
+struct JohnsonOptions {
+    BellmanFordOptions reweighting{BellmanFordMode::Spfa};
+    DijkstraOptions search;
+};
+
+namespace johnson_detail {
+
+constexpr char kMagic[8] = {'A', 'P', 'S', 'P', 'R', 'O', 'W', '1'};
+
+struct Header {
+    char magic[8];
+    uint64_t distanceSize;
+    uint64_t distanceIsFloat;
+    uint64_t vertices;
+    uint64_t rowsAt; // Byte position of row 0; row s follows at s * vertices entries
+};
+
+struct FdCloser {
+    int fd;
+    ~FdCloser() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+inline bool writeFully(int fd, uint64_t at, const void* src, size_t bytes) {
+    const char* p = static_cast<const char*>(src);
+    while (bytes > 0) {
+        ssize_t done = ::pwrite(fd, p, bytes, static_cast<off_t>(at));
+        if (done <= 0) return false;
+        p += done;
+        at += static_cast<uint64_t>(done);
+        bytes -= static_cast<size_t>(done);
+    }
+    return true;
+}
+
+// Runs one Dijkstra per source on searchGraph and calls onRow(source, row)
+// with the distances in the original weights: d(s, v) - h(s) + h(v), or the
+// search distances themselves if potential is empty.
+template <typename Id, typename SearchWeight, typename Distance, typename OnRow>
+void rows(const CsrGraph<Id, SearchWeight>& searchGraph, const std::vector<Distance>& potential,
+          const DijkstraOptions& options, ThreadPool& pool, OnRow& onRow) {
+    size_t n = searchGraph.numVertices();
+    std::atomic<size_t> next{0};
+    pool.parallelFor(pool.size(), [&](size_t) {
+        dijkstra_detail::withSearch(searchGraph, options, [&](auto& search) {
+            std::vector<Distance> row(n);
+            for (size_t s; (s = next.fetch_add(1, std::memory_order_relaxed)) < n;) {
+                search.run(static_cast<Id>(s));
+                for (size_t v = 0; v < n; ++v) {
+                    Id id = static_cast<Id>(v);
+                    if (!search.reached(id)) {
+                        row[v] = kDijkstraInfinity<Distance>;
+                    } else if (potential.empty()) {
+                        row[v] = search.distance(id);
+                    } else {
+                        row[v] = search.distance(id) - potential[s] + potential[v];
+                    }
+                }
+                onRow(static_cast<Id>(s), static_cast<const std::vector<Distance>&>(row));
+            }
+        });
+    });
+}
+
+} // namespace johnson_detail
+
+// Calls onRow(source, row) once for every source, where row[v] is the
+// shortest distance from source to v (kDijkstraInfinity if unreachable).
+// onRow runs on the pool's threads, concurrently for different sources, and
+// must not throw; the row is only valid during the call. Throws
+// std::invalid_argument on a negative cycle, before any row.
+template <typename Id, typename Weight, typename OnRow>
+void johnson(const CsrGraph<Id, Weight>& graph, OnRow&& onRow, const JohnsonOptions& options = {},
+             ThreadPool& pool = defaultThreadPool()) {
+    using Distance = DijkstraDistance<Weight>;
+    static_assert(std::is_same_v<Distance, BellmanFordDistance<Weight>>, "matching distance types");
+    if (options.search.queue == DijkstraQueue::RadixHeap && std::is_floating_point_v<Weight>) {
+        throw std::invalid_argument("johnson: the radix heap needs integer weights");
+    }
+    size_t n = graph.numVertices();
+    uint64_t m = graph.numEdges();
+    bool negative = false;
+    for (uint64_t e = 0; e < m && !negative; ++e) negative = graph.weight(e) < Weight(0);
+    if (!negative) {
+        johnson_detail::rows(graph, std::vector<Distance>(), options.search, pool, onRow);
+        return;
+    }
+
+    std::vector<Id> everyVertex(n);
+    for (size_t v = 0; v < n; ++v) everyVertex[v] = static_cast<Id>(v);
+    BellmanFordResult<Id, Distance> h = bellmanFord(graph, everyVertex, options.reweighting);
+    if (!h.negativeCycle.empty()) throw std::invalid_argument("johnson: negative cycle");
+
+    std::vector<uint64_t> offsets(n + 1);
+    for (size_t v = 0; v <= n; ++v) offsets[v] = v < n ? graph.edgeBegin(static_cast<Id>(v)) : m;
+    std::vector<Id> targets(m);
+    std::vector<Distance> weights(m);
+    pool.parallelFor(n, [&](size_t u) {
+        for (uint64_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+            Id v = graph.target(e);
+            targets[e] = v;
+            // Rounding can leave a floating-point weight just below 0
+            weights[e] = std::max(Distance(0), static_cast<Distance>(graph.weight(e)) + h.distance[u] - h.distance[v]);
+        }
+    }, 4096);
+    CsrGraph<Id, Distance> reweighted(std::move(offsets), std::move(targets), std::move(weights));
+    johnson_detail::rows(reweighted, h.distance, options.search, pool, onRow);
+}
+
+// Writes all rows to a file: a header, then the V x V matrix row by row
+// (written out of order, each at its own position). Read it back with
+// DistanceRowFile. Throws std::runtime_error if the file cannot be written.
+template <typename Id, typename Weight>
+void johnsonToFile(const CsrGraph<Id, Weight>& graph, const std::string& path, const JohnsonOptions& options = {},
+                   ThreadPool& pool = defaultThreadPool()) {
+    using Distance = DijkstraDistance<Weight>;
+    size_t n = graph.numVertices();
+    johnson_detail::Header h{};
+    std::memcpy(h.magic, johnson_detail::kMagic, sizeof(h.magic));
+    h.distanceSize = sizeof(Distance);
+    h.distanceIsFloat = std::is_floating_point_v<Distance>;
+    h.vertices = n;
+    h.rowsAt = csr_graph_detail::roundUp(sizeof(h), csr_graph_detail::kSectionAlign);
+
+    johnson_detail::FdCloser file{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+    if (file.fd < 0) throw std::runtime_error("johnson: cannot create " + path);
+    uint64_t bytes = h.rowsAt + static_cast<uint64_t>(n) * n * sizeof(Distance);
+    if (::ftruncate(file.fd, static_cast<off_t>(bytes)) != 0) throw std::runtime_error("johnson: cannot size " + path);
+    if (!johnson_detail::writeFully(file.fd, 0, &h, sizeof(h))) throw std::runtime_error("johnson: write failed for " + path);
+    std::atomic<bool> failed{false};
+    johnson(graph, [&](Id source, const std::vector<Distance>& row) {
+        uint64_t at = h.rowsAt + static_cast<uint64_t>(source) * n * sizeof(Distance);
+        if (!johnson_detail::writeFully(file.fd, at, row.data(), n * sizeof(Distance))) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    }, options, pool);
+    if (failed.load() || ::fsync(file.fd) != 0) throw std::runtime_error("johnson: write failed for " + path);
+}
+
+// Rows written by johnsonToFile, memory-mapped: only the rows that are read
+// are brought into memory.
+template <typename Distance>
+class DistanceRowFile {
+public:
+    // Throws std::runtime_error if the file is not a distance file or its
+    // distance type does not match.
+    static DistanceRowFile map(const std::string& path) {
+        DistanceRowFile file;
+        file.mapping = std::make_shared<csr_graph_detail::Mapping>(path);
+        johnson_detail::Header h;
+        if (file.mapping->size() < sizeof(h)) throw std::runtime_error("johnson: " + path + " is too short");
+        std::memcpy(&h, file.mapping->data(), sizeof(h));
+        if (std::memcmp(h.magic, johnson_detail::kMagic, sizeof(h.magic)) != 0) {
+            throw std::runtime_error("johnson: " + path + " is not a distance file");
+        }
+        if (h.distanceSize != sizeof(Distance) || h.distanceIsFloat != std::is_floating_point_v<Distance>) {
+            throw std::runtime_error("johnson: distance type does not match");
+        }
+        // One row fitting bounds h.vertices, so the row size cannot overflow
+        uint64_t size = file.mapping->size();
+        if (!csr_graph_detail::sectionFits(h.rowsAt, h.vertices, sizeof(Distance), size) ||
+            !csr_graph_detail::sectionFits(h.rowsAt, h.vertices, h.vertices * sizeof(Distance), size)) {
+            throw std::runtime_error("johnson: " + path + " is truncated or corrupt");
+        }
+        file.n = h.vertices;
+        file.data = reinterpret_cast<const Distance*>(file.mapping->data() + h.rowsAt);
+        return file;
+    }
+
+    size_t numVertices() const { return n; }
+    const Distance* row(size_t source) const { return data + source * n; }
+    Distance distance(size_t source, size_t target) const { return data[source * n + target]; }
+
+private:
+    std::shared_ptr<csr_graph_detail::Mapping> mapping;
+    const Distance* data = nullptr;
+    size_t n = 0;
+};
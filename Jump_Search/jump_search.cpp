@@ -1,6 +1,10 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include "jump_search.h"
 using namespace std;
 
 int jumpSearch(const vector<int>& arr, int target) {
@@ -30,6 +34,28 @@ int main() {
     } else {
         cout << "Element not found!" << endl;
     }
+
+    // Generic version from jump_search.h
+    cout << "Generic jumpSearch: index " << jumpSearch(arr.begin(), arr.end(), target) << endl;
+
+    // Many lookups at once, interleaved so that their probes overlap
+    const size_t n = size_t(1) << 22, queries = 100000;
+    mt19937_64 rng(5);
+    vector<int32_t> keys(n);
+    for (auto& k : keys) k = static_cast<int32_t>(rng());
+    sort(keys.begin(), keys.end());
+    vector<int32_t> probes(queries);
+    for (auto& q : probes) q = keys[rng() % n];
+
+    JumpSearch<int32_t> search(keys.data(), n);
+    vector<size_t> positions(queries);
+    interleavedSearch(search, probes.data(), queries, positions.data(), 8);
+    bool ok = true;
+    for (size_t i = 0; i < queries; ++i) ok = ok && keys[positions[i]] == probes[i];
+    cout << queries << " interleaved jump searches in " << n << " keys, all found: " << (ok ? "yes" : "no") << endl;
+    for (const InterleaveReport& r : profileInterleaving(search, probes.data(), queries)) {
+        cout << "  width " << r.width << ": " << r.lookupsPerSecond / 1e3 << " K lookups/s" << endl;
+    }
     return 0;
 }
 
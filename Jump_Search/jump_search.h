@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+
+#include "../Binary_Search/binary_search.h"
+
+// Generic jump search on a sorted array, and the same search as a state
+// machine for interleavedSearch (see Binary_Search/binary_search.h).
+//
+// Blocks of sqrt(n) elements are skipped by probing their last element; the
+// block that may hold the target is then scanned, one cache line per step.
+
+// Lower bound by jump search: the first position whose element is not less than x.
+template <typename T, typename Compare = std::less<>>
+size_t jumpLowerBound(const T* a, size_t n, const T& x, Compare cmp = Compare()) {
+    size_t step = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(n))));
+    size_t prev = 0;
+    while (prev < n && cmp(a[std::min(prev + step, n) - 1], x)) prev += step;
+    size_t end = std::min(prev + step, n);
+    while (prev < end && cmp(a[prev], x)) ++prev;
+    return std::min(prev, n);
+}
+
+// Index of an element equal to x, or -1.
+template <typename RandomIt, typename T, typename Compare = std::less<>>
+ptrdiff_t jumpSearch(RandomIt first, RandomIt last, const T& x, Compare cmp = Compare()) {
+    size_t n = static_cast<size_t>(last - first);
+    if (n == 0) return -1;
+    size_t i = jumpLowerBound(&*first, n, x, cmp);
+    return i < n && !cmp(x, first[i]) ? static_cast<ptrdiff_t>(i) : -1;
+}
+
+// jumpLowerBound as a state machine: one block probe, or one cache line of
+// the final scan, per step.
+template <typename T, typename Compare = std::less<>>
+class JumpSearch {
+public:
+    using Key = T;
+    struct State {
+        size_t pos;
+        size_t scanEnd; // 0 while still jumping
+        T key;
+    };
+
+    JumpSearch(const T* data, size_t n, Compare cmp = Compare())
+        : data(data), n(n), cmp(std::move(cmp)),
+          stride(std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(n))))) {}
+
+    void start(State& s, const T& key) const {
+        s.pos = 0;
+        s.scanEnd = 0;
+        s.key = key;
+        if (n > 0) __builtin_prefetch(data + std::min(stride, n) - 1);
+    }
+
+    bool step(State& s) const {
+        if (s.pos >= n) return true;
+        if (s.scanEnd == 0) {
+            size_t blockEnd = std::min(s.pos + stride, n);
+            if (cmp(data[blockEnd - 1], s.key)) {
+                s.pos = blockEnd;
+                if (s.pos >= n) return true;
+                __builtin_prefetch(data + std::min(s.pos + stride, n) - 1);
+                return false;
+            }
+            s.scanEnd = blockEnd;
+            __builtin_prefetch(data + s.pos);
+            return false;
+        }
+        size_t lineEnd = std::min(s.scanEnd, s.pos + kScanPerStep);
+        while (s.pos < lineEnd && cmp(data[s.pos], s.key)) ++s.pos;
+        if (s.pos < lineEnd || s.pos == s.scanEnd) return true;
+        __builtin_prefetch(data + s.pos);
+        return false;
+    }
+
+    size_t result(const State& s) const { return std::min(s.pos, n); }
+
+private:
+    static constexpr size_t kScanPerStep = std::max<size_t>(1, 64 / sizeof(T));
+
+    const T* data;
+    size_t n;
+    Compare cmp;
+    size_t stride;
+};
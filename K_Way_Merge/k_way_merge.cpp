@@ -0,0 +1,95 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "k_way_merge.h"
+using namespace std;
+
+struct Sample {
+    int64_t timestamp;
+    int shard;
+};
+
+template <typename Fn>
+double timeMs(Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    // Three per-shard time series, each sorted by timestamp
+    vector<vector<Sample>> shards = {
+        {{1, 0}, {4, 0}, {9, 0}},
+        {{2, 1}, {4, 1}, {7, 1}, {12, 1}},
+        {{3, 2}, {5, 2}}};
+    vector<pair<vector<Sample>::const_iterator, vector<Sample>::const_iterator>> ranges;
+    for (const auto& s : shards) ranges.push_back({s.begin(), s.end()});
+
+    auto byTime = [](const Sample& a, const Sample& b) { return a.timestamp < b.timestamp; };
+    cout << "Merged samples (timestamp/shard): ";
+    for (const Sample& s : mergeRanges(ranges, byTime)) cout << s.timestamp << "/" << s.shard << " ";
+    cout << endl;
+
+    // Pull-based sources: each one generates its own sorted sequence on demand
+    vector<PullCursor<int>::Source> sources;
+    for (int step : {3, 5, 7}) {
+        int next = step;
+        sources.push_back([next, step](int* out, size_t max) mutable {
+            size_t count = 0;
+            while (count < max && next <= 30) {
+                out[count++] = next;
+                next += step;
+            }
+            return count;
+        });
+    }
+    auto multiples = mergeSources<int>(move(sources), less<>(), 4);
+    cout << "Multiples of 3, 5, 7 up to 30: ";
+    int value;
+    while (multiples.next(value)) cout << value << " ";
+    cout << endl;
+
+    // Hundreds of sorted streams
+    const size_t k = 512, perStream = 20000;
+    mt19937_64 rng(42);
+    vector<vector<int64_t>> streams(k, vector<int64_t>(perStream));
+    for (auto& s : streams) {
+        for (auto& x : s) x = rng() % 1000000000;
+        sort(s.begin(), s.end());
+    }
+    vector<pair<const int64_t*, const int64_t*>> streamRanges;
+    for (const auto& s : streams) streamRanges.push_back({s.data(), s.data() + s.size()});
+
+    vector<int64_t> viaTree(k * perStream), viaHeap, viaSort;
+    double treeMs = timeMs([&] { kWayMerge(streamRanges, viaTree.begin()); });
+
+    double heapMs = timeMs([&] {
+        using Entry = pair<int64_t, size_t>;
+        priority_queue<Entry, vector<Entry>, greater<>> heap;
+        vector<size_t> pos(k, 0);
+        for (size_t i = 0; i < k; ++i) heap.push({streams[i][0], i});
+        viaHeap.reserve(k * perStream);
+        while (!heap.empty()) {
+            auto [v, i] = heap.top();
+            heap.pop();
+            viaHeap.push_back(v);
+            if (++pos[i] < perStream) heap.push({streams[i][pos[i]], i});
+        }
+    });
+
+    double sortMs = timeMs([&] {
+        for (const auto& s : streams) viaSort.insert(viaSort.end(), s.begin(), s.end());
+        sort(viaSort.begin(), viaSort.end());
+    });
+
+    cout << "Merging " << k << " streams of " << perStream << " elements:\n";
+    cout << "  loser tree:          " << treeMs << " ms\n";
+    cout << "  binary heap:         " << heapMs << " ms\n";
+    cout << "  concatenate + sort:  " << sortMs << " ms\n";
+    cout << "Results match: " << (viaTree == viaHeap && viaTree == viaSort ? "yes" : "no") << endl;
+    return 0;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Streaming k-way merge over sorted inputs, driven by a loser tree.
+//
+// Every input is a *cursor* with three members:
+//     bool exhausted() const;   // no more elements
+//     const T& head() const;    // current element (only if !exhausted())
+//     void advance();           // move to the next element
+// RangeCursor walks an in-memory sorted range, PullCursor wraps a pull-based
+// source and refills a small buffer in batches, and other modules supply their
+// own (External_Merge_Sort uses a double-buffered file reader).
+//
+// The merge is lazy: each pop() replays one leaf-to-root path of the loser tree
+// (at most ceil(log2 k) comparisons) and produces exactly one element. Ties go to the
+// input with the lower index, so the merge is stable.
+
+// Tournament tree of losers over k cursors. tree[0] holds the index of the
+// overall winner; internal node n (1 <= n < k) holds the index of the loser of
+// the game played there, and the leaf of cursor i sits at position k + i.
+// The current key of every cursor is copied once into the tree's own leaf
+// array, so a replay compares keys in that small array without touching the
+// k cursors, and moves only indices along the path. An exhausted cursor
+// becomes a +infinity sentinel (a flag in its leaf) that loses every game
+// without calling the comparator. value_type must be default constructible.
+template <typename Cursor, typename Compare>
+class LoserTree {
+public:
+    using value_type = std::decay_t<decltype(std::declval<const Cursor&>().head())>;
+
+    LoserTree(std::vector<Cursor>& cursors, Compare cmp)
+        : cursors(&cursors), cmp(std::move(cmp)), k(cursors.size()), leaves(k), tree(std::max<size_t>(k, 1)) {
+        if (k == 0) return;
+        for (size_t i = 0; i < k; ++i) load(i);
+        std::vector<size_t> winner(2 * k);
+        for (size_t i = 0; i < k; ++i) winner[k + i] = i;
+        for (size_t n = k - 1; n >= 1; --n) {
+            size_t a = winner[2 * n], b = winner[2 * n + 1];
+            winner[n] = play(a, b);
+            tree[n] = a ^ b ^ winner[n];
+        }
+        tree[0] = winner[1];
+    }
+
+    bool empty() const { return k == 0 || leaves[tree[0]].infinite; }
+    const value_type& top() const { return leaves[tree[0]].key; }
+    size_t topIndex() const { return tree[0]; }
+
+    // Advances the winning cursor and replays its path to the root.
+    void pop() {
+        size_t cur = tree[0];
+        (*cursors)[cur].advance();
+        load(cur);
+        for (size_t n = (cur + k) / 2; n >= 1; n /= 2) {
+            size_t stored = tree[n];
+            size_t winner = play(stored, cur);
+            tree[n] = stored ^ cur ^ winner;
+            cur = winner;
+        }
+        tree[0] = cur;
+    }
+
+private:
+    struct Leaf {
+        value_type key{};
+        bool infinite = true; // Exhausted cursor: key is stale and loses to everything
+    };
+
+    void load(size_t i) {
+        const Cursor& c = (*cursors)[i];
+        leaves[i].infinite = c.exhausted();
+        if (!leaves[i].infinite) leaves[i].key = c.head();
+    }
+
+    // The winner of inputs a and b under the strict order on (infinite, key,
+    // index), with at most one comparison: the input with the lower index is
+    // always the second argument, and wins ties. The picks use masks, because
+    // compilers turn a ?: on the outcome into a branch that random keys
+    // mispredict half the time.
+    size_t play(size_t a, size_t b) const {
+        if (leaves[a].infinite | leaves[b].infinite) return leaves[a].infinite ? b : a;
+        size_t lowMask = size_t(0) - static_cast<size_t>(a < b);
+        size_t low = b ^ ((a ^ b) & lowMask);
+        size_t high = a ^ b ^ low;
+        size_t lowWins = !cmp(leaves[high].key, leaves[low].key);
+        return high ^ ((low ^ high) & (size_t(0) - lowWins));
+    }
+
+    std::vector<Cursor>* cursors;
+    Compare cmp;
+    size_t k;
+    std::vector<Leaf> leaves;
+    std::vector<size_t> tree;
+};
+
+// Cursor over a sorted iterator range [first, last).
+template <typename It>
+class RangeCursor {
+public:
+    RangeCursor(It first, It last) : cur(first), end(last) {}
+    bool exhausted() const { return cur == end; }
+    const auto& head() const { return *cur; }
+    void advance() { ++cur; }
+
+private:
+    It cur, end;
+};
+
+// Cursor over a pull-based source: source(buffer, max) writes up to max
+// elements in sorted order and returns how many it wrote, 0 at the end.
+// Elements are pulled `batch` at a time so the source is called rarely and
+// the merge reads from a small, cache-resident buffer.
+template <typename T>
+class PullCursor {
+public:
+    using Source = std::function<size_t(T*, size_t)>;
+
+    PullCursor(Source source, size_t batch = 256)
+        : source(std::move(source)), buffer(std::max<size_t>(1, batch)) {
+        refill();
+    }
+
+    bool exhausted() const { return pos == length; }
+    const T& head() const { return buffer[pos]; }
+    void advance() {
+        if (++pos == length) refill();
+    }
+
+private:
+    void refill() {
+        pos = 0;
+        length = done ? 0 : source(buffer.data(), buffer.size());
+        done = length == 0;
+    }
+
+    Source source;
+    std::vector<T> buffer;
+    size_t pos = 0, length = 0;
+    bool done = false;
+};
+
+// Lazy merged stream over k cursors. Not copyable or movable, since the tree
+// refers to the cursor vector; the factory functions below rely on guaranteed
+// copy elision.
+template <typename Cursor, typename Compare = std::less<>>
+class KWayMerge {
+public:
+    using value_type = std::decay_t<decltype(std::declval<const Cursor&>().head())>;
+
+    explicit KWayMerge(std::vector<Cursor> inputs, Compare cmp = Compare())
+        : cursors(std::move(inputs)), tree(cursors, std::move(cmp)) {}
+
+    KWayMerge(const KWayMerge&) = delete;
+    KWayMerge& operator=(const KWayMerge&) = delete;
+
+    bool empty() const { return tree.empty(); }
+    const value_type& top() const { return tree.top(); }
+    size_t topSource() const { return tree.topIndex(); } // Input the top element came from
+    void pop() { tree.pop(); }
+
+    bool next(value_type& out) {
+        if (empty()) return false;
+        out = top();
+        pop();
+        return true;
+    }
+
+    // Copies up to max merged elements to out; returns how many were written.
+    size_t nextBatch(value_type* out, size_t max) {
+        size_t count = 0;
+        while (count < max && !empty()) {
+            out[count++] = top();
+            pop();
+        }
+        return count;
+    }
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename KWayMerge::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        iterator() = default;
+        explicit iterator(KWayMerge* merge) : merge(merge) {}
+        reference operator*() const { return merge->top(); }
+        pointer operator->() const { return &merge->top(); }
+        iterator& operator++() {
+            merge->pop();
+            return *this;
+        }
+        // Only comparison against end() is meaningful for an input iterator.
+        bool operator==(const iterator& other) const { return atEnd() == other.atEnd(); }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        bool atEnd() const { return merge == nullptr || merge->empty(); }
+        KWayMerge* merge = nullptr;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    std::vector<Cursor> cursors;
+    LoserTree<Cursor, Compare> tree;
+};
+
+// Merges sorted iterator ranges, e.g. {{a.begin(), a.end()}, {b.begin(), b.end()}}.
+template <typename It, typename Compare = std::less<>>
+KWayMerge<RangeCursor<It>, Compare> mergeRanges(const std::vector<std::pair<It, It>>& ranges,
+                                                Compare cmp = Compare()) {
+    std::vector<RangeCursor<It>> cursors;
+    cursors.reserve(ranges.size());
+    for (const auto& r : ranges) cursors.emplace_back(r.first, r.second);
+    return KWayMerge<RangeCursor<It>, Compare>(std::move(cursors), std::move(cmp));
+}
+
+// Merges pull-based sources, refilling each one `batch` elements at a time.
+template <typename T, typename Compare = std::less<>>
+KWayMerge<PullCursor<T>, Compare> mergeSources(std::vector<typename PullCursor<T>::Source> sources,
+                                               Compare cmp = Compare(), size_t batch = 256) {
+    std::vector<PullCursor<T>> cursors;
+    cursors.reserve(sources.size());
+    for (auto& s : sources) cursors.emplace_back(std::move(s), batch);
+    return KWayMerge<PullCursor<T>, Compare>(std::move(cursors), std::move(cmp));
+}
+
+// Writes the merge of sorted ranges to out and returns the end of the output.
+template <typename It, typename OutputIt, typename Compare = std::less<>>
+OutputIt kWayMerge(const std::vector<std::pair<It, It>>& ranges, OutputIt out, Compare cmp = Compare()) {
+    auto merge = mergeRanges(ranges, std::move(cmp));
+    for (; !merge.empty(); merge.pop()) *out++ = merge.top();
+    return out;
+}
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <vector>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include "linear_search.h"
 using namespace std;
 
 int linearSearch(const vector<int>& arr, int target) {
@@ -18,6 +22,52 @@ int main() {
     } else {
         cout << "Element not found!" << endl;
     }
+
+    // The same lookup with the vectorized scan, plus a few queries on it
+    cout << "Vectorized scan: index " << findFirst(arr.data(), arr.size(), target) << endl;
+    int32_t wanted[] = {50, 20, 35};
+    size_t hits[5];
+    size_t found = findAll(arr.data(), arr.size(), ScanQuery<int32_t>::anyOf(wanted, 3), hits);
+    cout << "Any of {50, 20, 35} at indices:";
+    for (size_t i = 0; i < found; ++i) cout << " " << hits[i];
+    cout << endl;
+    cout << "Count in [15, 45]: " << count(arr.data(), arr.size(), ScanQuery<int32_t>::inRange(15, 45)) << endl;
+
+    // One unsorted column of 16M keys; every query scans all of it
+    const size_t n = size_t(1) << 24;
+    mt19937 rng(1);
+    vector<int32_t> column(n);
+    for (auto& x : column) x = static_cast<int32_t>(rng() % 1000000);
+    int32_t targets[8];
+    for (auto& t : targets) t = -1 - static_cast<int32_t>(rng() % 100); // Not in the column
+    vector<size_t> out(n);
+
+    struct Case {
+        const char* name;
+        ScanQuery<int32_t> query;
+        int op; // 0: findFirst, 1: count, 2: findAll
+    };
+    Case cases[] = {
+        {"find first, absent key    ", ScanQuery<int32_t>::equalTo(-1), 0},
+        {"count one key             ", ScanQuery<int32_t>::equalTo(4242), 1},
+        {"find first of 8 targets   ", ScanQuery<int32_t>::anyOf(targets, 8), 0},
+        {"count in range (1%)       ", ScanQuery<int32_t>::inRange(0, 9999), 1},
+        {"find all in range (1%)    ", ScanQuery<int32_t>::inRange(0, 9999), 2},
+    };
+    const SimdLevel levels[] = {SimdLevel::Scalar, detectScanLevel()};
+    cout << "Scanning " << n << " int32 keys (ms, scalar vs "
+         << (levels[1] == SimdLevel::AVX2 ? "AVX2" : levels[1] == SimdLevel::SSE41 ? "SSE4.2" : "scalar") << "):" << endl;
+    for (const Case& c : cases) {
+        double ms[2];
+        size_t result[2];
+        for (int l = 0; l < 2; ++l) {
+            auto start = chrono::steady_clock::now();
+            if (c.op == 0) result[l] = findFirst(column.data(), n, c.query, levels[l]);
+            else if (c.op == 1) result[l] = count(column.data(), n, c.query, levels[l]);
+            else result[l] = findAll(column.data(), n, c.query, out.data(), levels[l]);
+            ms[l] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        }
+        cout << "  " << c.name << ms[0] << " vs " << ms[1] << (result[0] == result[1] ? "" : "  MISMATCH") << endl;
+    }
     return 0;
 }
-
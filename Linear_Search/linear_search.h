@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../Sorting_Network/sorting_network.h"
+
+// Vectorized linear scan over unsorted arrays of int32_t, int64_t, float or
+// double keys (e.g. one column of a table), for when building an index is not
+// worth it.
+//
+// A ScanQuery matches one key, any of up to 16 keys, or a closed range
+// [lo, hi]. findFirst, findAll and count then compare a whole vector of keys
+// per instruction (8 x 32-bit keys with AVX2, 4 with SSE) and turn the result
+// into a bit mask of matching lanes. The main loops handle four vectors per
+// iteration, so a find-first pays one branch per 32 keys.
+//
+// As in Sorting_Network/, the kernels are compiled with target pragmas and the
+// best one the CPU supports is picked at runtime; the SSE kernels need
+// SSE4.2 for 64-bit ordering. Floating-point comparisons are ordered: NaN never
+// matches, and -0.0 equals +0.0.
+namespace linear_search_detail {
+
+constexpr size_t kMaxTargets = 16;
+
+enum class MatchKind { Equal, AnyOf, InRange };
+
+template <typename T>
+struct IsScanKey : std::integral_constant<bool, std::is_same<T, int32_t>::value || std::is_same<T, int64_t>::value ||
+                                                    std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+} // namespace linear_search_detail
+
+template <typename T>
+class ScanQuery {
+    static_assert(linear_search_detail::IsScanKey<T>::value, "int32_t, int64_t, float or double keys only");
+
+public:
+    using MatchKind = linear_search_detail::MatchKind;
+    static constexpr size_t kMaxTargets = linear_search_detail::kMaxTargets;
+
+    static ScanQuery equalTo(T target) {
+        ScanQuery q(MatchKind::Equal);
+        q.values[0] = target;
+        q.count = 1;
+        return q;
+    }
+
+    // Matches keys equal to any of the m targets; m must be 1..kMaxTargets.
+    static ScanQuery anyOf(const T* targets, size_t m) {
+        if (m == 0 || m > kMaxTargets) throw std::invalid_argument("ScanQuery::anyOf takes 1 to 16 targets");
+        ScanQuery q(MatchKind::AnyOf);
+        std::copy(targets, targets + m, q.values);
+        q.count = m;
+        return q;
+    }
+
+    // Matches lo <= key <= hi.
+    static ScanQuery inRange(T lo, T hi) {
+        ScanQuery q(MatchKind::InRange);
+        q.values[0] = lo;
+        q.values[1] = hi;
+        q.count = 2;
+        return q;
+    }
+
+    bool matches(T x) const {
+        switch (kind) {
+        case MatchKind::Equal: return x == values[0];
+        case MatchKind::AnyOf: return std::find(values, values + count, x) != values + count;
+        case MatchKind::InRange: return values[0] <= x && x <= values[1];
+        }
+        return false;
+    }
+
+    MatchKind kind;
+    size_t count = 0;
+    T values[kMaxTargets] = {};
+
+private:
+    explicit ScanQuery(MatchKind kind) : kind(kind) {}
+};
+
+namespace linear_search_detail {
+
+// Scan kernels over Ops, which supplies kLanes, Vec, load, set1, eq,
+// inRange(x, lo, hi), orv and movemask (one bit per lane). Expanded once per
+// target region, like SORTING_NETWORK_BODY.
+#define LINEAR_SCAN_KERNELS(Name, OpsTemplate)                                              \
+    template <typename T, MatchKind Kind>                                                   \
+    struct Name {                                                                           \
+        using Ops = OpsTemplate<T>;                                                         \
+        using Vec = typename Ops::Vec;                                                      \
+        static constexpr size_t W = Ops::kLanes;                                            \
+                                                                                            \
+        struct Prepared {                                                                   \
+            Vec v[kMaxTargets];                                                             \
+            size_t count;                                                                   \
+        };                                                                                  \
+                                                                                            \
+        static Prepared prepare(const ScanQuery<T>& q) {                                    \
+            Prepared p;                                                                     \
+            p.count = q.count;                                                              \
+            for (size_t i = 0; i < q.count; ++i) p.v[i] = Ops::set1(q.values[i]);           \
+            return p;                                                                       \
+        }                                                                                   \
+                                                                                            \
+        static unsigned match(const Prepared& p, Vec x) {                                   \
+            if constexpr (Kind == MatchKind::Equal) {                                       \
+                return Ops::movemask(Ops::eq(x, p.v[0]));                                   \
+            } else if constexpr (Kind == MatchKind::AnyOf) {                                \
+                Vec m = Ops::eq(x, p.v[0]);                                                 \
+                for (size_t i = 1; i < p.count; ++i) m = Ops::orv(m, Ops::eq(x, p.v[i]));   \
+                return Ops::movemask(m);                                                    \
+            } else {                                                                        \
+                return Ops::movemask(Ops::inRange(x, p.v[0], p.v[1]));                      \
+            }                                                                               \
+        }                                                                                   \
+                                                                                            \
+        static size_t findFirst(const T* a, size_t n, const ScanQuery<T>& q) {              \
+            Prepared p = prepare(q);                                                        \
+            size_t i = 0;                                                                   \
+            for (; i + 4 * W <= n; i += 4 * W) {                                            \
+                unsigned m0 = match(p, Ops::load(a + i));                                   \
+                unsigned m1 = match(p, Ops::load(a + i + W));                               \
+                unsigned m2 = match(p, Ops::load(a + i + 2 * W));                           \
+                unsigned m3 = match(p, Ops::load(a + i + 3 * W));                           \
+                if ((m0 | m1 | m2 | m3) == 0) continue;                                     \
+                uint64_t all = m0 | (uint64_t(m1) << W) | (uint64_t(m2) << (2 * W)) |       \
+                               (uint64_t(m3) << (3 * W));                                   \
+                return i + static_cast<size_t>(__builtin_ctzll(all));                       \
+            }                                                                               \
+            for (; i + W <= n; i += W) {                                                    \
+                unsigned m = match(p, Ops::load(a + i));                                    \
+                if (m) return i + static_cast<size_t>(__builtin_ctz(m));                    \
+            }                                                                               \
+            for (; i < n; ++i) {                                                            \
+                if (q.matches(a[i])) return i;                                              \
+            }                                                                               \
+            return n;                                                                       \
+        }                                                                                   \
+                                                                                            \
+        static size_t count(const T* a, size_t n, const ScanQuery<T>& q) {                  \
+            Prepared p = prepare(q);                                                        \
+            size_t total = 0, i = 0;                                                        \
+            for (; i + 4 * W <= n; i += 4 * W) {                                            \
+                total += __builtin_popcount(match(p, Ops::load(a + i)));                    \
+                total += __builtin_popcount(match(p, Ops::load(a + i + W)));                \
+                total += __builtin_popcount(match(p, Ops::load(a + i + 2 * W)));            \
+                total += __builtin_popcount(match(p, Ops::load(a + i + 3 * W)));            \
+            }                                                                               \
+            for (; i + W <= n; i += W) total += __builtin_popcount(match(p, Ops::load(a + i))); \
+            for (; i < n; ++i) total += q.matches(a[i]);                                    \
+            return total;                                                                   \
+        }                                                                                   \
+                                                                                            \
+        static size_t findAll(const T* a, size_t n, const ScanQuery<T>& q, size_t* out) {   \
+            Prepared p = prepare(q);                                                        \
+            size_t found = 0, i = 0;                                                        \
+            for (; i + W <= n; i += W) {                                                    \
+                for (unsigned m = match(p, Ops::load(a + i)); m != 0; m &= m - 1) {         \
+                    out[found++] = i + static_cast<size_t>(__builtin_ctz(m));               \
+                }                                                                           \
+            }                                                                               \
+            for (; i < n; ++i) {                                                            \
+                if (q.matches(a[i])) out[found++] = i;                                      \
+            }                                                                               \
+            return found;                                                                   \
+        }                                                                                   \
+    };
+
+template <typename T, MatchKind Kind>
+struct ScalarScan {
+    static size_t findFirst(const T* a, size_t n, const ScanQuery<T>& q) {
+        for (size_t i = 0; i < n; ++i) {
+            if (q.matches(a[i])) return i;
+        }
+        return n;
+    }
+    static size_t count(const T* a, size_t n, const ScanQuery<T>& q) {
+        size_t total = 0;
+        for (size_t i = 0; i < n; ++i) total += q.matches(a[i]);
+        return total;
+    }
+    static size_t findAll(const T* a, size_t n, const ScanQuery<T>& q, size_t* out) {
+        size_t found = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (q.matches(a[i])) out[found++] = i;
+        }
+        return found;
+    }
+};
+
+#ifdef SORTING_NETWORK_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+
+template <typename T>
+struct Sse42ScanOps;
+
+template <>
+struct Sse42ScanOps<int32_t> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m128i;
+    static Vec load(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static Vec set1(int32_t x) { return _mm_set1_epi32(x); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi32(a, b); }
+    static Vec orv(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) {
+        return _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi32(lo, x), _mm_cmpgt_epi32(x, hi)), _mm_set1_epi32(-1));
+    }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m))); }
+};
+
+template <>
+struct Sse42ScanOps<int64_t> {
+    static constexpr size_t kLanes = 2;
+    using Vec = __m128i;
+    static Vec load(const int64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static Vec set1(int64_t x) { return _mm_set1_epi64x(x); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi64(a, b); }
+    static Vec orv(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) {
+        return _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi64(lo, x), _mm_cmpgt_epi64(x, hi)), _mm_set1_epi32(-1));
+    }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(m))); }
+};
+
+template <>
+struct Sse42ScanOps<float> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m128;
+    static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    static Vec set1(float x) { return _mm_set1_ps(x); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_ps(a, b); }
+    static Vec orv(Vec a, Vec b) { return _mm_or_ps(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) { return _mm_and_ps(_mm_cmple_ps(lo, x), _mm_cmple_ps(x, hi)); }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+};
+
+template <>
+struct Sse42ScanOps<double> {
+    static constexpr size_t kLanes = 2;
+    using Vec = __m128d;
+    static Vec load(const double* p) { return _mm_loadu_pd(p); }
+    static Vec set1(double x) { return _mm_set1_pd(x); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_pd(a, b); }
+    static Vec orv(Vec a, Vec b) { return _mm_or_pd(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) { return _mm_and_pd(_mm_cmple_pd(lo, x), _mm_cmple_pd(x, hi)); }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm_movemask_pd(m)); }
+};
+
+LINEAR_SCAN_KERNELS(Sse42Scan, Sse42ScanOps)
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+template <typename T>
+struct Avx2ScanOps;
+
+template <>
+struct Avx2ScanOps<int32_t> {
+    static constexpr size_t kLanes = 8;
+    using Vec = __m256i;
+    static Vec load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static Vec set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi32(a, b); }
+    static Vec orv(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) {
+        return _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi32(lo, x), _mm256_cmpgt_epi32(x, hi)),
+                                   _mm256_set1_epi32(-1));
+    }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m))); }
+};
+
+template <>
+struct Avx2ScanOps<int64_t> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m256i;
+    static Vec load(const int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static Vec set1(int64_t x) { return _mm256_set1_epi64x(x); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi64(a, b); }
+    static Vec orv(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) {
+        return _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi64(lo, x), _mm256_cmpgt_epi64(x, hi)),
+                                   _mm256_set1_epi32(-1));
+    }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(m))); }
+};
+
+template <>
+struct Avx2ScanOps<float> {
+    static constexpr size_t kLanes = 8;
+    using Vec = __m256;
+    static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static Vec set1(float x) { return _mm256_set1_ps(x); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static Vec orv(Vec a, Vec b) { return _mm256_or_ps(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) {
+        return _mm256_and_ps(_mm256_cmp_ps(lo, x, _CMP_LE_OQ), _mm256_cmp_ps(x, hi, _CMP_LE_OQ));
+    }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+};
+
+template <>
+struct Avx2ScanOps<double> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m256d;
+    static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    static Vec set1(double x) { return _mm256_set1_pd(x); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static Vec orv(Vec a, Vec b) { return _mm256_or_pd(a, b); }
+    static Vec inRange(Vec x, Vec lo, Vec hi) {
+        return _mm256_and_pd(_mm256_cmp_pd(lo, x, _CMP_LE_OQ), _mm256_cmp_pd(x, hi, _CMP_LE_OQ));
+    }
+    static unsigned movemask(Vec m) { return static_cast<unsigned>(_mm256_movemask_pd(m)); }
+};
+
+LINEAR_SCAN_KERNELS(Avx2Scan, Avx2ScanOps)
+
+#pragma GCC pop_options
+
+#endif // SORTING_NETWORK_X86
+
+#undef LINEAR_SCAN_KERNELS
+
+// Calls fn with an (empty) kernel object for the query kind and SIMD level.
+template <typename T, typename Fn>
+auto withKernel(const ScanQuery<T>& q, SimdLevel level, Fn&& fn) {
+    auto forKind = [&](auto kind) {
+        constexpr MatchKind K = decltype(kind)::value;
+#ifdef SORTING_NETWORK_X86
+        if (level == SimdLevel::AVX2) return fn(Avx2Scan<T, K>());
+        if (level == SimdLevel::SSE41) return fn(Sse42Scan<T, K>());
+#endif
+        (void)level;
+        return fn(ScalarScan<T, K>());
+    };
+    switch (q.kind) {
+    case MatchKind::Equal: return forKind(std::integral_constant<MatchKind, MatchKind::Equal>());
+    case MatchKind::AnyOf: return forKind(std::integral_constant<MatchKind, MatchKind::AnyOf>());
+    default: return forKind(std::integral_constant<MatchKind, MatchKind::InRange>());
+    }
+}
+
+} // namespace linear_search_detail
+
+// Kernel family used by the scans: detectSimdLevel(), except that the SSE
+// kernels also need SSE4.2.
+inline SimdLevel detectScanLevel() {
+    SimdLevel level = detectSimdLevel();
+#ifdef SORTING_NETWORK_X86
+    if (level == SimdLevel::SSE41 && !__builtin_cpu_supports("sse4.2")) level = SimdLevel::Scalar;
+#endif
+    return level;
+}
+
+// Index of the first key that matches q, or n if none does.
+template <typename T>
+size_t findFirst(const T* a, size_t n, const ScanQuery<T>& q, SimdLevel level = detectScanLevel()) {
+    return linear_search_detail::withKernel(q, level, [&](auto k) { return decltype(k)::findFirst(a, n, q); });
+}
+
+// Number of keys that match q.
+template <typename T>
+size_t count(const T* a, size_t n, const ScanQuery<T>& q, SimdLevel level = detectScanLevel()) {
+    return linear_search_detail::withKernel(q, level, [&](auto k) { return decltype(k)::count(a, n, q); });
+}
+
+// Writes the indices of all matching keys, in order, to out (which needs room
+// for up to n entries) and returns how many there are.
+template <typename T>
+size_t findAll(const T* a, size_t n, const ScanQuery<T>& q, size_t* out, SimdLevel level = detectScanLevel()) {
+    return linear_search_detail::withKernel(q, level, [&](auto k) { return decltype(k)::findAll(a, n, q, out); });
+}
+
+// Single-key shorthand: index of the first key equal to target, or n.
+template <typename T>
+size_t findFirst(const T* a, size_t n, T target, SimdLevel level = detectScanLevel()) {
+    return findFirst(a, n, ScanQuery<T>::equalTo(target), level);
+}
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "merge_sort.h"
 using namespace std;
 
 void merge(vector<int>& arr, int left, int mid, int right) {
@@ -34,11 +38,48 @@ void printArray(const vector<int>& arr) {
     cout << endl;
 }
 
+struct LogRecord {
+    int timestamp;
+    int sequence; // Original position, used to check stability
+};
+
 int main() {
     vector<int> arr = {12, 11, 13, 5, 6, 7};
     mergeSort(arr, 0, arr.size() - 1);
     cout << "Sorted array: ";
     printArray(arr);
+
+    // Large batch through the parallel engine, keyed on timestamp only
+    const int n = 2000000;
+    mt19937 rng(42);
+    vector<LogRecord> records(n);
+    for (int i = 0; i < n; ++i) records[i] = {int(rng() % 1000), i};
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i) keys[i] = records[i].timestamp;
+
+    auto start = chrono::steady_clock::now();
+    mergeSort(keys, 0, n - 1);
+    double classicMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    vector<LogRecord> scratch; // Reusable across sorts
+    start = chrono::steady_clock::now();
+    parallelMergeSort(records.begin(), records.end(), scratch,
+                      [](const LogRecord& a, const LogRecord& b) { return a.timestamp < b.timestamp; });
+    double parallelMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    bool stable = true;
+    for (int i = 1; i < n; ++i) {
+        if (records[i - 1].timestamp > records[i].timestamp ||
+            (records[i - 1].timestamp == records[i].timestamp &&
+             records[i - 1].sequence > records[i].sequence)) {
+            stable = false;
+            break;
+        }
+    }
+
+    cout << "Sorted " << n << " records on " << defaultThreadPool().size() << " thread(s)\n";
+    cout << "Classic mergeSort: " << classicMs << " ms\n";
+    cout << "parallelMergeSort: " << parallelMs << " ms\n";
+    cout << "Stable and sorted: " << (stable ? "yes" : "no") << endl;
     return 0;
 }
-
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "../Insertion_Sort/insertion_sort.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Templated, stable merge sort engine.
+//
+// One auxiliary buffer of n elements is used for the whole sort. Recursion
+// levels alternate between the input and the buffer ("ping-pong"), so every
+// merge writes straight into its destination and nothing is copied back.
+// The top levels run on a ThreadPool: the input is cut into independent
+// chunks, and each merge round is split into equal pieces with merge-path
+// co-ranking so that even the final merge uses every thread. Subarrays of at
+// most LeafSort::kMaxLeafSize elements are handed to the LeafSort policy.
+namespace merge_sort_detail {
+
+constexpr size_t kParallelCutoff = 1 << 15;   // Below this, sort on one thread
+constexpr size_t kMinMergePiece = 1 << 14;    // Smallest slice of a merge per task
+
+// Stable merge of [l, lEnd) and [r, rEnd) into out; ties are taken from the left.
+template <typename T, typename Compare>
+void mergeRuns(T* l, T* lEnd, T* r, T* rEnd, T* out, Compare& cmp) {
+    while (l != lEnd && r != rEnd) {
+        if (cmp(*r, *l)) *out++ = std::move(*r++);
+        else *out++ = std::move(*l++);
+    }
+    out = std::move(l, lEnd, out);
+    std::move(r, rEnd, out);
+}
+
+// Merge-path co-rank: how many of the first `diag` merged outputs come from
+// the left run, consistent with the tie-breaking of mergeRuns.
+template <typename T, typename Compare>
+size_t coRank(size_t diag, const T* l, size_t n1, const T* r, size_t n2, Compare& cmp) {
+    size_t lo = diag > n2 ? diag - n2 : 0;
+    size_t hi = std::min(diag, n1);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (!cmp(r[diag - i - 1], l[i])) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+// Sorts a[0, n). The result ends up in b when toBuffer is set, otherwise in a.
+// Children sort into the opposite buffer so the merge never copies back.
+template <typename LeafSort, typename T, typename Compare>
+void sortInto(T* a, T* b, size_t n, bool toBuffer, Compare& cmp) {
+    if (n <= LeafSort::kMaxLeafSize) {
+        LeafSort::sort(a, a + n, cmp);
+        if (toBuffer) std::move(a, a + n, b);
+        return;
+    }
+    size_t half = n / 2;
+    sortInto<LeafSort>(a, b, half, !toBuffer, cmp);
+    sortInto<LeafSort>(a + half, b + half, n - half, !toBuffer, cmp);
+    T* src = toBuffer ? a : b;
+    T* dst = toBuffer ? b : a;
+    mergeRuns(src, src + half, src + half, src + n, dst, cmp);
+}
+
+template <typename LeafSort, typename T, typename Compare>
+void parallelSort(T* a, T* b, size_t n, Compare& cmp, ThreadPool& pool) {
+    size_t threads = pool.size();
+    if (n < kParallelCutoff || threads == 1) {
+        sortInto<LeafSort>(a, b, n, false, cmp);
+        return;
+    }
+
+    // Power-of-two chunk count, a few chunks per thread for load balance.
+    size_t levels = 0;
+    while ((size_t(1) << levels) < threads * 4 &&
+           (n >> (levels + 1)) >= LeafSort::kMaxLeafSize * 64) {
+        ++levels;
+    }
+    size_t chunks = size_t(1) << levels;
+    auto bound = [n, chunks](size_t c) { return c * n / chunks; };
+
+    // After `levels` ping-pong rounds the data must be back in a.
+    bool leavesInBuffer = levels % 2 == 1;
+    pool.parallelFor(chunks, [&](size_t c) {
+        sortInto<LeafSort>(a + bound(c), b + bound(c), bound(c + 1) - bound(c), leavesInBuffer, cmp);
+    });
+
+    struct Piece { size_t lo, mid, hi, outBegin, outEnd; };
+    std::vector<Piece> pieces;
+    for (size_t level = 0; level < levels; ++level) {
+        T* src = (levels - level) % 2 == 1 ? b : a;
+        T* dst = src == a ? b : a;
+        size_t width = size_t(1) << (level + 1);
+
+        pieces.clear();
+        for (size_t c = 0; c < chunks; c += width) {
+            size_t lo = bound(c), mid = bound(c + width / 2), hi = bound(c + width);
+            size_t total = hi - lo;
+            size_t parts = std::max<size_t>(1, std::min(threads * 2 * width / chunks,
+                                                        total / kMinMergePiece));
+            for (size_t p = 0; p < parts; ++p) {
+                pieces.push_back({lo, mid, hi, p * total / parts, (p + 1) * total / parts});
+            }
+        }
+
+        pool.parallelFor(pieces.size(), [&](size_t k) {
+            const Piece& pc = pieces[k];
+            T* l = src + pc.lo;
+            T* r = src + pc.mid;
+            size_t n1 = pc.mid - pc.lo, n2 = pc.hi - pc.mid;
+            size_t i0 = coRank(pc.outBegin, l, n1, r, n2, cmp);
+            size_t i1 = coRank(pc.outEnd, l, n1, r, n2, cmp);
+            mergeRuns(l + i0, l + i1, r + (pc.outBegin - i0), r + (pc.outEnd - i1),
+                      dst + pc.lo + pc.outBegin, cmp);
+        });
+    }
+}
+
+} // namespace merge_sort_detail
+
+// Sorts the contiguous range [first, last) stably, using `scratch` as the one
+// auxiliary buffer. The scratch vector is grown if needed and can be reused
+// across calls to avoid any allocation at all.
+template <typename LeafSort = InsertionLeafSort, typename RandomIt, typename Compare = std::less<>>
+void parallelMergeSort(RandomIt first, RandomIt last,
+                       std::vector<typename std::iterator_traits<RandomIt>::value_type>& scratch,
+                       Compare cmp = Compare(), ThreadPool& pool = defaultThreadPool()) {
+    size_t n = static_cast<size_t>(last - first);
+    if (n < 2) return;
+    if (scratch.size() < n) scratch.resize(n);
+    merge_sort_detail::parallelSort<LeafSort>(&*first, scratch.data(), n, cmp, pool);
+}
+
+// Same as above, allocating a single scratch buffer for this sort.
+template <typename LeafSort = InsertionLeafSort, typename RandomIt, typename Compare = std::less<>>
+void parallelMergeSort(RandomIt first, RandomIt last, Compare cmp = Compare(),
+                       ThreadPool& pool = defaultThreadPool()) {
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> scratch;
+    parallelMergeSort<LeafSort>(first, last, scratch, cmp, pool);
+}
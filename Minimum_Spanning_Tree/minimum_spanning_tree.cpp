@@ -0,0 +1,62 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include <string>
+#include "../CSR_Graph/csr_graph.h"
+#include "minimum_spanning_tree.h"
+using namespace std;
+
+void printForest(const string& name, const SpanningForest<uint32_t, int32_t>& forest) {
+    cout << name << ":";
+    for (const auto& e : forest.edges) cout << " " << e.source << "-" << e.target << " (" << e.weight << ")";
+    cout << ", total " << forest.totalWeight << endl;
+}
+
+int main() {
+    // The example graph of the Prim module, as an edge list
+    vector<CsrEdge<uint32_t, int32_t>> small = {
+        {0, 1, 2}, {0, 3, 6}, {1, 2, 3}, {1, 3, 8}, {1, 4, 5}, {2, 4, 7}, {3, 4, 9},
+    };
+    CsrBuildOptions undirected;
+    undirected.symmetrize = true;
+    printForest("Prim   ", primMst(CsrGraph<>::fromEdges(5, small, undirected)));
+    printForest("Kruskal", kruskalMst(5, small));
+    printForest("Boruvka", boruvkaMst(5, small));
+
+    // A random graph: 2^21 vertices, 2^24 edges, weights 1..1000000
+    const size_t n = size_t(1) << 21, m = size_t(1) << 24;
+    mt19937_64 rng(29);
+    vector<CsrEdge<uint32_t, int32_t>> edges(m);
+    for (auto& e : edges) e = {uint32_t(rng() % n), uint32_t(rng() % n), int32_t(1 + rng() % 1000000)};
+    cout << "Random graph: " << n << " vertices, " << m << " edges (an adjacency matrix would need "
+         << double(n) * n * sizeof(int) / (1ull << 40) << " TB)" << endl;
+
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    auto start = chrono::steady_clock::now();
+    CsrGraph<> graph = CsrGraph<>::fromEdges(n, edges, undirected);
+    cout << "  building the CSR graph for Prim: " << since(start) << " ms" << endl;
+
+    start = chrono::steady_clock::now();
+    SpanningForest<uint32_t, int32_t> prim = primMst(graph);
+    cout << "  Prim (indexed 4-ary heap): " << since(start) << " ms, " << prim.edges.size() << " edges, total "
+         << prim.totalWeight << endl;
+
+    start = chrono::steady_clock::now();
+    SpanningForest<uint32_t, int32_t> kruskal = kruskalMst(n, edges);
+    cout << "  Kruskal (radix sort):      " << since(start) << " ms, same total: "
+         << (kruskal.totalWeight == prim.totalWeight ? "yes" : "no") << endl;
+
+    for (size_t threads : {1, 2, 4}) {
+        ThreadPool pool(threads);
+        start = chrono::steady_clock::now();
+        SpanningForest<uint32_t, int32_t> boruvka = boruvkaMst(n, edges, pool);
+        double ms = since(start);
+        cout << "  Boruvka, " << threads << " thread" << (threads > 1 ? "s: " : ":  ") << ms
+             << " ms, same total: " << (boruvka.totalWeight == prim.totalWeight ? "yes" : "no") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Dijkstras_Algorithm/dijkstras_algorithm.h"
+#include "../Radix_Sort/radix_sort.h"
+#include "../Thread_Pool/thread_pool.h"
+#include "../Union_Find_Algorithm/union_find_algorithm.h"
+
+// Minimum spanning forests of sparse undirected graphs.
+//
+// - primMst: Prim's algorithm on a CsrGraph that stores every edge in both
+//   directions. The cheapest edge into each vertex outside the tree is kept
+//   in an indexed 4-ary heap, so each step costs O(log V) instead of a scan
+//   of all vertices.
+// - kruskalMst: Kruskal's algorithm on an edge list. The edges are sorted by
+//   weight with the parallel LSD radix sort, then added in order unless
+//   UnionFind shows that both ends are already connected.
+// - boruvkaMst: Boruvka's algorithm on an edge list, on all threads of the
+//   pool. Every round, each component picks its cheapest outgoing edge with
+//   atomic compare-and-swap minimums, the picked edges join the forest, the
+//   components they connect are merged by pointer jumping, and edges inside
+//   a component are dropped. The number of components at least halves every
+//   round. The edges carry their components, which are renumbered 0..k-1
+//   each round, so later rounds index arrays of k entries that stay in
+//   cache instead of V-sized ones.
+//
+// Disconnected graphs give one tree per component. Edges of equal weight are
+// ordered by their position in the list, which makes the minimum unique:
+// Kruskal and Boruvka return the same edges, Prim the same total weight.
+// Unlike an adjacency matrix, an edge list has no "no edge" value, so weight
+// 0 and negative weights are ordinary edges.
+
+template <typename Weight>
+using SpanningTreeWeight = std::conditional_t<std::is_floating_point_v<Weight>, double, int64_t>;
+
+template <typename Id, typename Weight>
+struct SpanningForest {
+    std::vector<CsrEdge<Id, Weight>> edges; // V - (number of components) edges
+    SpanningTreeWeight<Weight> totalWeight = 0;
+};
+
+namespace mst_detail {
+
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+
+template <typename Weight>
+constexpr Weight kHeaviest = std::numeric_limits<Weight>::has_infinity ? std::numeric_limits<Weight>::infinity()
+                                                                       : std::numeric_limits<Weight>::max();
+
+template <typename Id, typename Weight>
+void checkEdges(size_t n, const std::vector<CsrEdge<Id, Weight>>& edges, const char* name) {
+    for (const CsrEdge<Id, Weight>& e : edges) {
+        if (e.source >= n || e.target >= n) {
+            throw std::invalid_argument(std::string(name) + ": edge endpoint out of range");
+        }
+    }
+}
+
+template <typename Id, typename Weight>
+void add(SpanningForest<Id, Weight>& forest, const CsrEdge<Id, Weight>& e) {
+    forest.edges.push_back(e);
+    forest.totalWeight += static_cast<SpanningTreeWeight<Weight>>(e.weight);
+}
+
+// An edge between two components, which are numbered 0..k-1 in every round.
+template <typename Id, typename Weight>
+struct Arc {
+    Weight weight;
+    Id u, v;
+    uint64_t edge; // Index in the input
+};
+
+// Atomic minimum, for the weights and positions of the cheapest arcs.
+template <typename T>
+void lowerTo(std::atomic<T>& best, T value) {
+    T current = best.load(std::memory_order_relaxed);
+    while (value < current && !best.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace mst_detail
+
+// Prim's algorithm from every vertex not yet in a tree. The graph must be
+// undirected, storing each edge as u -> v and v -> u.
+template <typename Id, typename Weight>
+SpanningForest<Id, Weight> primMst(const CsrGraph<Id, Weight>& graph) {
+    size_t n = graph.numVertices();
+    SpanningForest<Id, Weight> forest;
+    std::vector<Id> parent(n);
+    std::vector<uint64_t> parentEdge(n, mst_detail::kNoEdge); // Cheapest edge from the tree
+    std::vector<bool> inTree(n, false);
+    IndexedDaryHeap<Id, Weight, 4> heap(n);
+    for (size_t root = 0; root < n; ++root) {
+        if (inTree[root]) continue;
+        heap.push(static_cast<Id>(root), Weight());
+        while (!heap.empty()) {
+            Id u = heap.pop().second;
+            inTree[u] = true;
+            if (parentEdge[u] != mst_detail::kNoEdge) mst_detail::add(forest, {parent[u], u, graph.weight(parentEdge[u])});
+            for (uint64_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+                Id v = graph.target(e);
+                if (inTree[v]) continue;
+                Weight w = graph.weight(e);
+                if (parentEdge[v] == mst_detail::kNoEdge || w < graph.weight(parentEdge[v])) {
+                    parent[v] = u;
+                    parentEdge[v] = e;
+                    heap.push(v, w);
+                }
+            }
+        }
+    }
+    return forest;
+}
+
+// Kruskal's algorithm on the undirected edges of an n-vertex graph (each
+// edge listed once). Throws std::invalid_argument for an endpoint >= n or if
+// n does not fit UnionFind's int elements.
+template <typename Id, typename Weight>
+SpanningForest<Id, Weight> kruskalMst(size_t n, const std::vector<CsrEdge<Id, Weight>>& edges,
+                                      ThreadPool& pool = defaultThreadPool()) {
+    if (n > static_cast<size_t>(INT_MAX)) throw std::invalid_argument("kruskalMst: too many vertices");
+    mst_detail::checkEdges(n, edges, "kruskalMst");
+    std::vector<CsrEdge<Id, Weight>> sorted(edges);
+    parallelRadixSort(sorted.begin(), sorted.end(), [](const CsrEdge<Id, Weight>& e) { return e.weight; }, pool);
+
+    SpanningForest<Id, Weight> forest;
+    UnionFind components(static_cast<int>(n));
+    for (const CsrEdge<Id, Weight>& e : sorted) {
+        if (components.unionSets(static_cast<int>(e.source), static_cast<int>(e.target))) {
+            mst_detail::add(forest, e);
+            if (forest.edges.size() + 1 == n) break;
+        }
+    }
+    return forest;
+}
+
+// Boruvka's algorithm on the undirected edges of an n-vertex graph (each
+// edge listed once), on all threads of the pool. Throws
+// std::invalid_argument for an endpoint >= n.
+template <typename Id, typename Weight>
+SpanningForest<Id, Weight> boruvkaMst(size_t n, const std::vector<CsrEdge<Id, Weight>>& edges,
+                                      ThreadPool& pool = defaultThreadPool()) {
+    using mst_detail::kNoEdge;
+    mst_detail::checkEdges(n, edges, "boruvkaMst");
+    constexpr size_t kBlock = 1 << 14;
+    std::vector<mst_detail::Arc<Id, Weight>> arcs(edges.size());
+    pool.parallelFor(edges.size(), [&](size_t e) {
+        arcs[e] = {edges[e].weight, edges[e].source, edges[e].target, e};
+    }, 4096);
+    std::vector<size_t> live; // Arcs at the front of each block of kBlock
+    for (size_t first = 0; first < arcs.size(); first += kBlock) live.push_back(std::min(kBlock, arcs.size() - first));
+    std::vector<Id> rename(n), next(n), jump(n); // Indexed by component
+    std::vector<uint64_t> picked(n);
+    std::vector<std::atomic<Weight>> lightest(n);
+    std::vector<std::atomic<uint64_t>> best(n); // Position of the cheapest arc
+    std::iota(rename.begin(), rename.end(), Id(0));
+
+    SpanningForest<Id, Weight> forest;
+    for (size_t k = n; k > 1;) {
+        // Renames the ends of every arc to this round's components and drops
+        // the arcs inside one; each block keeps its crossing arcs at its
+        // front. The cheapest arc out of each component is found in two
+        // steps, its weight and then its position among the arcs of that
+        // weight, so neither step reads another arc.
+        pool.parallelFor(k, [&](size_t c) {
+            lightest[c].store(mst_detail::kHeaviest<Weight>, std::memory_order_relaxed);
+            best[c].store(kNoEdge, std::memory_order_relaxed);
+        }, 4096);
+        pool.parallelFor(live.size(), [&](size_t b) {
+            size_t first = b * kBlock, out = first;
+            for (size_t i = first; i < first + live[b]; ++i) {
+                mst_detail::Arc<Id, Weight> a = arcs[i];
+                a.u = rename[a.u];
+                a.v = rename[a.v];
+                if (a.u == a.v) continue;
+                arcs[out++] = a;
+                mst_detail::lowerTo(lightest[a.u], a.weight);
+                mst_detail::lowerTo(lightest[a.v], a.weight);
+            }
+            live[b] = out - first;
+        });
+        size_t remaining = std::accumulate(live.begin(), live.end(), size_t(0));
+        if (remaining == 0) break;
+        pool.parallelFor(live.size(), [&](size_t b) {
+            for (size_t at = b * kBlock; at < b * kBlock + live[b]; ++at) {
+                const mst_detail::Arc<Id, Weight>& a = arcs[at];
+                if (a.weight == lightest[a.u].load(std::memory_order_relaxed)) mst_detail::lowerTo(best[a.u], uint64_t(at));
+                if (a.weight == lightest[a.v].load(std::memory_order_relaxed)) mst_detail::lowerTo(best[a.v], uint64_t(at));
+            }
+        });
+
+        // Each component hooks onto the one its arc leads to. Two components
+        // that picked the same arc point at each other; the lower id stays a
+        // root and the higher one adds the edge.
+        pool.parallelFor(k, [&](size_t c) {
+            uint64_t at = best[c].load(std::memory_order_relaxed);
+            next[c] = static_cast<Id>(c);
+            picked[c] = kNoEdge;
+            if (at == kNoEdge) return;
+            const mst_detail::Arc<Id, Weight>& a = arcs[at];
+            Id other = a.u == c ? a.v : a.u;
+            if (best[other].load(std::memory_order_relaxed) == at && c < other) return;
+            next[c] = other;
+            picked[c] = a.edge;
+        }, 1024);
+        for (bool changed = true; changed;) {
+            std::atomic<bool> moving{false};
+            pool.parallelFor(k, [&](size_t c) {
+                jump[c] = next[next[c]];
+                if (jump[c] != next[c]) moving.store(true, std::memory_order_relaxed);
+            }, 4096);
+            pool.parallelFor(k, [&](size_t c) { next[c] = jump[c]; }, 4096);
+            changed = moving.load();
+        }
+
+        // Numbers the merged components 0, 1, ... for the next round.
+        // Components without an arc are finished and get no number.
+        size_t roots = 0;
+        for (size_t c = 0; c < k; ++c) {
+            if (picked[c] != kNoEdge) mst_detail::add(forest, edges[picked[c]]);
+            if (next[c] == c && best[c].load(std::memory_order_relaxed) != kNoEdge) rename[c] = static_cast<Id>(roots++);
+        }
+        pool.parallelFor(k, [&](size_t c) {
+            if (next[c] != c) rename[c] = rename[next[c]];
+        }, 4096);
+        k = roots;
+
+        // Packs the blocks together once at least half of the arcs are gone.
+        if (remaining <= arcs.size() / 2) {
+            std::vector<size_t> at(live.size() + 1, 0);
+            for (size_t b = 0; b < live.size(); ++b) at[b + 1] = at[b] + live[b];
+            std::vector<mst_detail::Arc<Id, Weight>> packed(remaining);
+            pool.parallelFor(live.size(), [&](size_t b) {
+                std::copy(arcs.begin() + b * kBlock, arcs.begin() + b * kBlock + live[b], packed.begin() + at[b]);
+            });
+            arcs.swap(packed);
+            live.clear();
+            for (size_t first = 0; first < arcs.size(); first += kBlock) live.push_back(std::min(kBlock, arcs.size() - first));
+        }
+    }
+    return forest;
+}
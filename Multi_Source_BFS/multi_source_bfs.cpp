@@ -0,0 +1,117 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include "../CSR_Graph/csr_graph.h"
+#include "../Breadth_First_Search/breadth_first_search.h"
+#include "multi_source_bfs.h"
+using namespace std;
+
+// Level sizes from one direction-optimizing BFS per source
+vector<vector<uint64_t>> bfsPerSource(const CsrGraph<>& graph, const vector<uint32_t>& sources) {
+    vector<vector<uint64_t>> levels;
+    for (uint32_t s : sources) {
+        BfsResult<uint32_t> r = parallelBfs(graph, s);
+        vector<uint64_t> sizes;
+        for (uint32_t d : r.distance) {
+            if (d == kBfsUnreached<uint32_t>) continue;
+            if (d >= sizes.size()) sizes.resize(d + 1, 0);
+            ++sizes[d];
+        }
+        levels.push_back(sizes);
+    }
+    return levels;
+}
+
+int main() {
+    // The adjacency list used by the BFS and DFS examples
+    vector<vector<int>> lists = {
+        {1, 2},  // Node 0 is connected to 1 and 2
+        {0, 3},  // Node 1 is connected to 0 and 3
+        {0, 4},  // Node 2 is connected to 0 and 4
+        {1},     // Node 3 is connected to 1
+        {2}      // Node 4 is connected to 2
+    };
+    CsrGraph<> small = CsrGraph<>::fromAdjacencyList(lists);
+    vector<uint32_t> everyNode = {0, 1, 2, 3, 4};
+    vector<vector<uint64_t>> levels = multiSourceBfs(small, everyNode);
+    for (uint32_t v : everyNode) {
+        cout << "Node " << v << ": level sizes";
+        for (uint64_t count : levels[v]) cout << " " << count;
+        cout << ", within 2 hops " << kHopCount(levels[v], 2) << ", closeness " << closeness(levels[v]) << endl;
+    }
+
+    // A low-diameter, skewed-degree graph (R-MAT, like a social network):
+    // 2^18 vertices, 16 edges per vertex, undirected
+    const int scale = 18;
+    const size_t n = size_t(1) << scale, m = 16 * n;
+    mt19937_64 rng(11);
+    uniform_real_distribution<double> coin(0, 1);
+    vector<pair<uint32_t, uint32_t>> edges(m);
+    for (auto& e : edges) {
+        uint32_t u = 0, v = 0;
+        for (int bit = 0; bit < scale; ++bit) {
+            double r = coin(rng);
+            int quadrant = r < 0.57 ? 0 : r < 0.76 ? 1 : r < 0.95 ? 2 : 3;
+            u = 2 * u + (quadrant >> 1);
+            v = 2 * v + (quadrant & 1);
+        }
+        e = {u, v};
+    }
+    CsrBuildOptions undirected;
+    undirected.symmetrize = true;
+    undirected.dropSelfLoops = true;
+    CsrGraph<> social = CsrGraph<>::fromEdges(n, edges, undirected);
+
+    // 512 sources among the vertices with edges
+    vector<uint32_t> sources;
+    for (uint32_t v = 0; v < n && sources.size() < 512; v += 97) {
+        if (social.degree(v) > 0) sources.push_back(v);
+    }
+    cout << "Closeness of " << sources.size() << " sources on " << n << " vertices, " << social.numEdges()
+         << " directed edges:" << endl;
+
+    auto start = chrono::steady_clock::now();
+    vector<vector<uint64_t>> expected = bfsPerSource(social, sources);
+    double singleMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "  one BFS per source:    " << singleMs << " ms" << endl;
+
+    for (size_t batch : {64, 512}) {
+        start = chrono::steady_clock::now();
+        vector<vector<uint64_t>> found;
+        for (size_t first = 0; first < sources.size(); first += batch) {
+            vector<uint32_t> part(sources.begin() + first, sources.begin() + min(sources.size(), first + batch));
+            vector<vector<uint64_t>> sizes = multiSourceBfs(social, part);
+            found.insert(found.end(), sizes.begin(), sizes.end());
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "  MS-BFS, " << batch << " per batch: " << (batch < 100 ? " " : "") << ms << " ms, results match: "
+             << (found == expected ? "yes" : "no") << endl;
+    }
+    size_t best = 0;
+    for (size_t i = 1; i < sources.size(); ++i) {
+        if (closeness(expected[i]) > closeness(expected[best])) best = i;
+    }
+    cout << "Most central source: " << sources[best] << " (closeness " << closeness(expected[best])
+         << ", " << kHopCount(expected[best], 2) << " vertices within 2 hops)" << endl;
+
+    // A long path: 20000 levels with a frontier of at most 2 vertices per
+    // source, where push steps read only the edges of the frontier
+    const size_t length = 20000;
+    vector<pair<uint32_t, uint32_t>> pathEdges;
+    for (uint32_t v = 0; v + 1 < length; ++v) pathEdges.push_back({v, v + 1});
+    CsrGraph<> path = CsrGraph<>::fromEdges(length, pathEdges, undirected);
+    vector<uint32_t> pathSources;
+    for (uint32_t v = 0; v < length && pathSources.size() < 64; v += 311) pathSources.push_back(v);
+    cout << "Path of " << length << " vertices, " << pathSources.size() << " sources:" << endl;
+    start = chrono::steady_clock::now();
+    expected = bfsPerSource(path, pathSources);
+    cout << "  one BFS per source:    " << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()
+         << " ms" << endl;
+    start = chrono::steady_clock::now();
+    vector<vector<uint64_t>> found = multiSourceBfs(path, pathSources);
+    cout << "  MS-BFS:                " << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()
+         << " ms, results match: " << (found == expected ? "yes" : "no") << endl;
+    return 0;
+}
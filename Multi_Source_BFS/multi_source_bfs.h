@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../CSR_Graph/csr_graph.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Multi-source BFS (MS-BFS, Then et al.): runs BFS from a batch of 64 to 512
+// sources at once, with one bit per source.
+//
+// Every vertex v has three bitsets: seen[v] (sources that have reached v),
+// visit[v] (sources whose frontier contains v) and next[v]. The frontier is
+// also kept as a list of the vertices whose visit[v] is not empty. A level
+// sets next[v] to the sources that reach v for the first time, in one of two
+// ways, as in the direction-optimizing BFS:
+// - Push (top-down): every frontier vertex u ORs visit[u] & ~seen[v] into
+//   next[v] for each out-neighbor v, with an atomic OR. It reads only the
+//   edges of the frontier, so narrow frontiers (long paths, the first and
+//   last levels) cost little.
+// - Pull (bottom-up): every vertex not yet seen by all sources ORs visit[u]
+//   over its in-neighbors u. Each vertex is written by one task only, and the
+//   OR/AND-NOT over 1 to 8 words compiles to vector instructions. It wins
+//   when the frontier's edges are a large part of the edges still open.
+// Either way, each edge carries the whole batch across with one OR, instead
+// of one scan per source. The step with the smaller estimated cost is chosen
+// at every level.
+//
+// The result of a run is the number of vertices at each distance from each
+// source, which gives closeness centrality and k-hop neighborhood sizes.
+namespace ms_bfs_detail {
+
+constexpr size_t kVertexGrain = 4096;   // Vertices per pull task
+constexpr size_t kFrontierGrain = 256;  // Frontier vertices per push or settle task
+constexpr uint64_t kPushEdgeCost = 4;   // A pushed edge (random atomic OR) against a pulled one
+
+// The state of one batch with Words x 64 sources.
+template <size_t Words, typename Id, typename Weight>
+class Batch {
+public:
+    static constexpr size_t kSources = Words * 64;
+
+    Batch(const CsrGraph<Id, Weight>& graph, const CsrGraph<Id, Weight>& inGraph, ThreadPool& pool)
+        : graph(graph), inGraph(inGraph), pool(pool), n(graph.numVertices()), seen(n * Words, 0),
+          visit(n * Words, 0), next(n * Words, 0), queued(n, 0), openInEdges(inGraph.numEdges()) {}
+
+    // Sets up the batch; lanes past count stay unused and are marked seen
+    // everywhere, so that a vertex every source has reached is all ones.
+    void start(const Id* sources, size_t count) {
+        for (size_t w = 0; w < Words; ++w) {
+            size_t used = std::min<size_t>(64, count > w * 64 ? count - w * 64 : 0);
+            uint64_t unused = used == 64 ? 0 : ~uint64_t(0) << used;
+            if (unused == 0) continue;
+            for (size_t v = 0; v < n; ++v) seen[v * Words + w] = unused;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            size_t v = static_cast<size_t>(sources[i]);
+            uint64_t bit = uint64_t(1) << (i % 64);
+            seen[v * Words + i / 64] |= bit;
+            visit[v * Words + i / 64] |= bit;
+            if (queued[v]) continue;
+            queued[v] = 1;
+            frontier.push_back(static_cast<Id>(v));
+        }
+        frontierEdges = 0;
+        for (Id v : frontier) {
+            queued[v] = 0;
+            frontierEdges += graph.degree(v);
+            if (complete(v)) openInEdges -= inGraph.degree(v);
+        }
+    }
+
+    // Expands one level. Returns false if no source reached a new vertex;
+    // otherwise reached(i) is the number of vertices source i reached.
+    bool expand() {
+        if (frontier.empty()) return false;
+        if (frontierEdges * kPushEdgeCost < openInEdges) push();
+        else pull();
+        nextFrontier.clear();
+        for (const auto& part : found) nextFrontier.insert(nextFrontier.end(), part.begin(), part.end());
+        settle();
+        // visit is non-empty only on the old frontier; clear it for reuse as next
+        for (Id u : frontier) std::fill_n(visit.begin() + static_cast<size_t>(u) * Words, Words, 0);
+        std::swap(visit, next);
+        std::swap(frontier, nextFrontier);
+        return !frontier.empty();
+    }
+
+    uint64_t reached(size_t source) const {
+        uint64_t total = 0;
+        for (size_t at = source; at < usedCounts; at += kSources) total += counts[at];
+        return total;
+    }
+
+private:
+    bool complete(Id v) const {
+        uint64_t all = ~uint64_t(0);
+        for (size_t w = 0; w < Words; ++w) all &= seen[static_cast<size_t>(v) * Words + w];
+        return all == ~uint64_t(0);
+    }
+
+    void resizeFound(size_t tasks) {
+        if (found.size() < tasks) found.resize(tasks);
+        for (auto& part : found) part.clear();
+    }
+
+    void push() {
+        size_t tasks = (frontier.size() + kFrontierGrain - 1) / kFrontierGrain;
+        resizeFound(tasks);
+        pool.parallelFor(tasks, [&](size_t t) {
+            size_t end = std::min(frontier.size(), (t + 1) * kFrontierGrain);
+            for (size_t i = t * kFrontierGrain; i < end; ++i) {
+                const uint64_t* in = visit.data() + static_cast<size_t>(frontier[i]) * Words;
+                for (Id v : graph.neighbors(frontier[i])) {
+                    const uint64_t* s = seen.data() + static_cast<size_t>(v) * Words;
+                    uint64_t* out = next.data() + static_cast<size_t>(v) * Words;
+                    bool added = false;
+                    for (size_t w = 0; w < Words; ++w) {
+                        uint64_t bits = in[w] & ~s[w];
+                        if ((__atomic_load_n(&out[w], __ATOMIC_RELAXED) & bits) == bits) continue;
+                        __atomic_fetch_or(&out[w], bits, __ATOMIC_RELAXED);
+                        added = true;
+                    }
+                    if (added && __atomic_exchange_n(&queued[v], 1, __ATOMIC_RELAXED) == 0) found[t].push_back(v);
+                }
+            }
+        });
+    }
+
+    void pull() {
+        size_t tasks = (n + kVertexGrain - 1) / kVertexGrain;
+        resizeFound(tasks);
+        pool.parallelFor(tasks, [&](size_t t) {
+            size_t end = std::min(n, (t + 1) * kVertexGrain);
+            for (size_t v = t * kVertexGrain; v < end; ++v) {
+                if (complete(static_cast<Id>(v))) continue;
+                const uint64_t* s = seen.data() + v * Words;
+                uint64_t acc[Words] = {};
+                for (Id u : inGraph.neighbors(static_cast<Id>(v))) {
+                    const uint64_t* in = visit.data() + static_cast<size_t>(u) * Words;
+                    for (size_t w = 0; w < Words; ++w) acc[w] |= in[w];
+                }
+                uint64_t any = 0;
+                for (size_t w = 0; w < Words; ++w) {
+                    acc[w] &= ~s[w];
+                    any |= acc[w];
+                }
+                if (any == 0) continue;
+                std::copy(acc, acc + Words, next.data() + v * Words);
+                found[t].push_back(static_cast<Id>(v));
+            }
+        });
+    }
+
+    // Merges next into seen for the new frontier and counts, per source and
+    // task, the vertices it reached. Also updates the cost estimates.
+    void settle() {
+        size_t tasks = (nextFrontier.size() + kFrontierGrain - 1) / kFrontierGrain;
+        usedCounts = tasks * kSources;
+        if (counts.size() < usedCounts) counts.resize(usedCounts);
+        std::fill_n(counts.begin(), usedCounts, 0);
+        std::vector<uint64_t> degrees(tasks, 0), closed(tasks, 0);
+        pool.parallelFor(tasks, [&](size_t t) {
+            uint32_t* taskCounts = counts.data() + t * kSources;
+            size_t end = std::min(nextFrontier.size(), (t + 1) * kFrontierGrain);
+            for (size_t i = t * kFrontierGrain; i < end; ++i) {
+                Id v = nextFrontier[i];
+                uint64_t* s = seen.data() + static_cast<size_t>(v) * Words;
+                const uint64_t* out = next.data() + static_cast<size_t>(v) * Words;
+                for (size_t w = 0; w < Words; ++w) {
+                    s[w] |= out[w];
+                    for (uint64_t bits = out[w]; bits != 0; bits &= bits - 1) {
+                        ++taskCounts[w * 64 + __builtin_ctzll(bits)];
+                    }
+                }
+                queued[v] = 0;
+                degrees[t] += graph.degree(v);
+                if (complete(v)) closed[t] += inGraph.degree(v);
+            }
+        });
+        frontierEdges = 0;
+        for (size_t t = 0; t < tasks; ++t) {
+            frontierEdges += degrees[t];
+            openInEdges -= closed[t];
+        }
+    }
+
+    const CsrGraph<Id, Weight>& graph;
+    const CsrGraph<Id, Weight>& inGraph;
+    ThreadPool& pool;
+    size_t n;
+    std::vector<uint64_t> seen, visit, next;
+    std::vector<uint8_t> queued;                // v is already in the next frontier list
+    std::vector<Id> frontier, nextFrontier;
+    std::vector<std::vector<Id>> found;         // New frontier vertices per task
+    std::vector<uint32_t> counts;               // counts[task * kSources + s], kept across levels
+    size_t usedCounts = 0;
+    uint64_t frontierEdges = 0;                 // Out-edges of the frontier
+    uint64_t openInEdges;                       // In-edges of vertices some source has not reached
+};
+
+// Runs one batch of up to Words x 64 sources, appending to levelSizes.
+template <size_t Words, typename Id, typename Weight>
+void runBatch(const CsrGraph<Id, Weight>& graph, const CsrGraph<Id, Weight>& inGraph, const Id* sources,
+              size_t count, size_t maxDepth, std::vector<std::vector<uint64_t>>& levelSizes, ThreadPool& pool) {
+    Batch<Words, Id, Weight> batch(graph, inGraph, pool);
+    batch.start(sources, count);
+    size_t first = levelSizes.size();
+    for (size_t i = 0; i < count; ++i) levelSizes.push_back({1});
+    for (size_t depth = 1; depth <= maxDepth; ++depth) {
+        if (!batch.expand()) break;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t reached = batch.reached(i);
+            if (reached) levelSizes[first + i].push_back(reached);
+        }
+    }
+}
+
+} // namespace ms_bfs_detail
+
+// BFS from every source over a directed graph; result[i][d] is the number of
+// vertices at distance d from sources[i] (result[i][0] == 1). Levels beyond
+// maxDepth are not explored. inGraph must be graph.reversed() (the in-edges),
+// which pull steps scan. Sources are processed in batches of up to 512; a
+// smaller set uses a narrower batch.
+template <typename Id, typename Weight>
+std::vector<std::vector<uint64_t>> multiSourceBfs(const CsrGraph<Id, Weight>& graph,
+                                                  const CsrGraph<Id, Weight>& inGraph, const std::vector<Id>& sources,
+                                                  size_t maxDepth = std::numeric_limits<size_t>::max(),
+                                                  ThreadPool& pool = defaultThreadPool()) {
+    using namespace ms_bfs_detail;
+    std::vector<std::vector<uint64_t>> levelSizes;
+    levelSizes.reserve(sources.size());
+    for (size_t done = 0; done < sources.size();) {
+        size_t count = std::min<size_t>(512, sources.size() - done);
+        const Id* batch = sources.data() + done;
+        if (count <= 64) runBatch<1>(graph, inGraph, batch, count, maxDepth, levelSizes, pool);
+        else if (count <= 128) runBatch<2>(graph, inGraph, batch, count, maxDepth, levelSizes, pool);
+        else if (count <= 256) runBatch<4>(graph, inGraph, batch, count, maxDepth, levelSizes, pool);
+        else runBatch<8>(graph, inGraph, batch, count, maxDepth, levelSizes, pool);
+        done += count;
+    }
+    return levelSizes;
+}
+
+// The same over an undirected graph (every edge stored in both directions),
+// which is its own in-edge graph.
+template <typename Id, typename Weight>
+std::vector<std::vector<uint64_t>> multiSourceBfs(const CsrGraph<Id, Weight>& graph, const std::vector<Id>& sources,
+                                                  size_t maxDepth = std::numeric_limits<size_t>::max(),
+                                                  ThreadPool& pool = defaultThreadPool()) {
+    return multiSourceBfs(graph, graph, sources, maxDepth, pool);
+}
+
+// Closeness centrality of a source from its level sizes: (reached - 1) divided
+// by the sum of distances to the reached vertices; 0 if it reaches nothing.
+inline double closeness(const std::vector<uint64_t>& levels) {
+    uint64_t reached = 0, distanceSum = 0;
+    for (size_t d = 0; d < levels.size(); ++d) {
+        reached += levels[d];
+        distanceSum += d * levels[d];
+    }
+    return distanceSum ? static_cast<double>(reached - 1) / static_cast<double>(distanceSum) : 0.0;
+}
+
+// Number of vertices within k hops of a source (including itself).
+inline uint64_t kHopCount(const std::vector<uint64_t>& levels, size_t k) {
+    uint64_t total = 0;
+    for (size_t d = 0; d < levels.size() && d <= k; ++d) total += levels[d];
+    return total;
+}
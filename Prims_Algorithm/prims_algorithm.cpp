@@ -1,6 +1,9 @@
 #include <iostream>
 #include <vector>
 #include <climits>
+#include <cstdint>
+#include "../CSR_Graph/csr_graph.h"
+#include "../Minimum_Spanning_Tree/minimum_spanning_tree.h"
 using namespace std;
 
 int findMinVertex(vector<int>& key, vector<bool>& inMST, int V) {
@@ -39,6 +42,19 @@ void primsMST(vector<vector<int>>& graph, int V) {
     }
 }
 
+// The same algorithm on the shared CSR graph type (undirected: every edge is
+// stored in both directions), with the engine of the Minimum_Spanning_Tree
+// module: the cheapest edge into each vertex is kept in an indexed heap
+// instead of being found by a scan of all vertices.
+void primsMST(const CsrGraph<>& graph) {
+    SpanningForest<uint32_t, int32_t> forest = primMst(graph);
+    cout << "Edge \tWeight (CSR)\n";
+    for (const auto& e : forest.edges) {
+        cout << e.source << " - " << e.target << " \t" << e.weight << endl;
+    }
+    cout << "Total weight: " << forest.totalWeight << endl;
+}
+
 int main() {
     vector<vector<int>> graph = {
         {0, 2, 0, 6, 0},
@@ -50,6 +66,7 @@ int main() {
 
     int V = graph.size();
     primsMST(graph, V);
+    primsMST(CsrGraph<>::fromAdjacencyMatrix(graph, 0));
 
     return 0;
 }
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "quick_sort.h"
 using namespace std;
 
 int partition(vector<int>& arr, int low, int high) {
@@ -34,6 +38,33 @@ int main() {
     quickSort(arr, 0, arr.size() - 1);
     cout << "Sorted array: ";
     printArray(arr);
+
+    // Inputs that drive the Lomuto version to O(n^2)
+    const int n = 20000;
+    vector<int> sortedInput(n), equalInput(n, 7);
+    for (int i = 0; i < n; ++i) sortedInput[i] = i;
+
+    for (auto* input : {&sortedInput, &equalInput}) {
+        vector<int> a = *input, b = *input;
+        auto start = chrono::steady_clock::now();
+        quickSort(a, 0, n - 1);
+        double classicMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        introSort(b.begin(), b.end());
+        double introMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << (input == &sortedInput ? "Sorted input:    " : "All-equal input: ")
+             << "quickSort " << classicMs << " ms, introSort " << introMs << " ms\n";
+    }
+
+    // Duplicate-heavy random keys at a larger size
+    mt19937 rng(7);
+    vector<int> keys(5000000);
+    for (int& k : keys) k = rng() % 16;
+    auto start = chrono::steady_clock::now();
+    introSort(keys.begin(), keys.end());
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "introSort on " << keys.size() << " keys with 16 distinct values: " << ms << " ms, "
+         << (is_sorted(keys.begin(), keys.end()) ? "sorted" : "NOT sorted") << endl;
     return 0;
 }
 
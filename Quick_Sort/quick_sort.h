@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "../Insertion_Sort/insertion_sort.h"
+
+// Introsort-style production quicksort.
+//
+// - Pivot: median-of-3, or Tukey's ninther on larger ranges.
+// - Partition: branchless block partitioning (BlockQuicksort). Misplaced
+//   elements are first recorded in small offset buffers without branching on
+//   the comparison result, then swapped in bulk.
+// - Duplicates: when the chosen pivot equals the element just left of the
+//   range, every element equal to the pivot is split off in one "fat"
+//   partition and never touched again, so few-unique inputs stay O(n log k).
+// - Small ranges are finished by the LeafSort policy (insertion sort by
+//   default), and a heapsort fallback
+//   at depth 2*log2(n) bounds the worst case at O(n log n).
+// - The loop recurses into the smaller side only, so stack depth is O(log n).
+namespace quick_sort_detail {
+
+constexpr ptrdiff_t kNintherThreshold = 128;
+constexpr ptrdiff_t kBlockSize = 64;
+
+template <typename T, typename Compare>
+void sort2(T* a, T* b, Compare& cmp) {
+    if (cmp(*b, *a)) std::iter_swap(a, b);
+}
+
+// Orders three elements so that the median ends up in *b.
+template <typename T, typename Compare>
+void sort3(T* a, T* b, T* c, Compare& cmp) {
+    sort2(a, b, cmp);
+    sort2(b, c, cmp);
+    sort2(a, b, cmp);
+}
+
+// Moves a median-of-3 or ninther pivot to *lo.
+template <typename T, typename Compare>
+void choosePivot(T* lo, T* hi, Compare& cmp) {
+    ptrdiff_t n = hi - lo;
+    T* mid = lo + n / 2;
+    if (n > kNintherThreshold) {
+        sort3(lo, mid, hi - 1, cmp);
+        sort3(lo + 1, mid - 1, hi - 2, cmp);
+        sort3(lo + 2, mid + 1, hi - 3, cmp);
+        sort3(mid - 1, mid, mid + 1, cmp);
+    } else {
+        sort3(lo, mid, hi - 1, cmp);
+    }
+    std::iter_swap(lo, mid);
+}
+
+// Partitions [lo, hi) around the pivot stored in *lo. Returns the final pivot
+// position p: [lo, p) < pivot and [p + 1, hi) >= pivot.
+template <typename T, typename Compare>
+T* blockPartition(T* lo, T* hi, Compare& cmp) {
+    T pivot = std::move(*lo);
+    T* first = lo + 1;
+    T* last = hi;
+
+    unsigned char offsetsL[kBlockSize];
+    unsigned char offsetsR[kBlockSize];
+    ptrdiff_t numL = 0, numR = 0, startL = 0, startR = 0;
+
+    while (last - first > 2 * kBlockSize) {
+        if (numL == 0) {
+            startL = 0;
+            for (ptrdiff_t i = 0; i < kBlockSize; ++i) {
+                offsetsL[numL] = static_cast<unsigned char>(i);
+                numL += !cmp(first[i], pivot); // Branchless: count misplaced
+            }
+        }
+        if (numR == 0) {
+            startR = 0;
+            for (ptrdiff_t i = 0; i < kBlockSize; ++i) {
+                offsetsR[numR] = static_cast<unsigned char>(i);
+                numR += cmp(*(last - 1 - i), pivot);
+            }
+        }
+        ptrdiff_t num = std::min(numL, numR);
+        for (ptrdiff_t k = 0; k < num; ++k) {
+            std::iter_swap(first + offsetsL[startL + k], last - 1 - offsetsR[startR + k]);
+        }
+        numL -= num;
+        numR -= num;
+        startL += num;
+        startR += num;
+        if (numL == 0) first += kBlockSize;
+        if (numR == 0) last -= kBlockSize;
+    }
+
+    // A block with leftover offsets has not been skipped, so it is still inside
+    // [first, last) and the scalar pass below simply re-examines it.
+    for (;;) {
+        while (first < last && cmp(*first, pivot)) ++first;
+        while (first < last && !cmp(*(last - 1), pivot)) --last;
+        if (first >= last) break;
+        std::iter_swap(first, last - 1);
+        ++first;
+        --last;
+    }
+
+    T* p = first - 1;
+    if (p != lo) *lo = std::move(*p);
+    *p = std::move(pivot);
+    return p;
+}
+
+// Fat partition used when the pivot equals its left neighbour, i.e. the whole
+// range is >= pivot. Moves every element equal to the pivot to the front and
+// returns the first element greater than it.
+template <typename T, typename Compare>
+T* partitionEqual(T* lo, T* hi, Compare& cmp) {
+    T pivot = *lo;
+    T* first = lo + 1;
+    T* last = hi;
+    for (;;) {
+        while (first < last && !cmp(pivot, *first)) ++first;
+        while (first < last && cmp(pivot, *(last - 1))) --last;
+        if (first >= last) break;
+        std::iter_swap(first, last - 1);
+        ++first;
+        --last;
+    }
+    return first;
+}
+
+template <typename LeafSort, typename T, typename Compare>
+void introSortLoop(T* lo, T* hi, int depthLimit, bool leftmost, Compare& cmp) {
+    while (hi - lo > static_cast<ptrdiff_t>(LeafSort::kMaxLeafSize)) {
+        if (depthLimit == 0) {
+            std::make_heap(lo, hi, cmp);
+            std::sort_heap(lo, hi, cmp);
+            return;
+        }
+        --depthLimit;
+
+        choosePivot(lo, hi, cmp);
+        if (!leftmost && !cmp(*(lo - 1), *lo)) {
+            lo = partitionEqual(lo, hi, cmp);
+            continue;
+        }
+
+        T* p = blockPartition(lo, hi, cmp);
+        if (p - lo < hi - (p + 1)) {
+            introSortLoop<LeafSort>(lo, p, depthLimit, leftmost, cmp);
+            lo = p + 1;
+            leftmost = false;
+        } else {
+            introSortLoop<LeafSort>(p + 1, hi, depthLimit, false, cmp);
+            hi = p;
+        }
+    }
+    LeafSort::sort(lo, hi, cmp);
+}
+
+} // namespace quick_sort_detail
+
+// Sorts the contiguous range [first, last) in O(n log n) worst case. Not stable.
+template <typename LeafSort = InsertionLeafSort, typename RandomIt, typename Compare = std::less<>>
+void introSort(RandomIt first, RandomIt last, Compare cmp = Compare()) {
+    ptrdiff_t n = last - first;
+    if (n < 2) return;
+    int depthLimit = 0;
+    for (ptrdiff_t k = n; k > 1; k >>= 1) depthLimit += 2;
+    auto* lo = &*first;
+    quick_sort_detail::introSortLoop<LeafSort>(lo, lo + n, depthLimit, true, cmp);
+}
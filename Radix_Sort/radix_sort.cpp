@@ -0,0 +1,62 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "radix_sort.h"
+using namespace std;
+
+struct Activity {
+    int start, finish;
+};
+
+struct Interval {
+    int start, end;
+};
+
+int main() {
+    // Struct keys through a key extractor
+    vector<Activity> activities = {{1, 3}, {2, 5}, {4, 6}, {6, 7}, {5, 9}, {8, 9}, {0, 2}};
+    radixSort(activities.begin(), activities.end(), [](const Activity& a) { return a.finish; });
+    cout << "Activities by finish: ";
+    for (const auto& a : activities) cout << "(" << a.start << ", " << a.finish << ") ";
+    cout << endl;
+
+    // Signed keys
+    vector<Interval> intervals = {{5, 8}, {-3, 1}, {2, 5}, {-10, -4}, {0, 6}};
+    msdRadixSort(intervals.begin(), intervals.end(), [](const Interval& i) { return i.start; });
+    cout << "Intervals by start: ";
+    for (const auto& i : intervals) cout << "[" << i.start << ", " << i.end << "] ";
+    cout << endl;
+
+    // Floating-point keys, including negatives
+    vector<double> readings = {3.5, -0.25, 12.0, -7.75, 0.0, 1e-9, -1e9};
+    radixSort(readings.begin(), readings.end());
+    cout << "Readings: ";
+    for (double r : readings) cout << r << " ";
+    cout << endl;
+
+    // 64-bit timestamps at scale
+    const size_t n = 10000000;
+    mt19937_64 rng(42);
+    vector<uint64_t> timestamps(n);
+    for (auto& t : timestamps) t = 1700000000000000ULL + rng() % 100000000000ULL;
+    vector<uint64_t> a = timestamps, b = timestamps, c = timestamps;
+
+    auto time = [](auto&& fn) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    double stdMs = time([&] { sort(a.begin(), a.end()); });
+    double lsdMs = time([&] { radixSort(b.begin(), b.end()); });
+    double parMs = time([&] { parallelRadixSort(c.begin(), c.end()); });
+
+    cout << "Sorting " << n << " 64-bit timestamps:\n";
+    cout << "std::sort:         " << stdMs << " ms\n";
+    cout << "radixSort:         " << lsdMs << " ms\n";
+    cout << "parallelRadixSort: " << parMs << " ms (" << defaultThreadPool().size() << " threads)\n";
+    cout << "Results match: " << (a == b && a == c ? "yes" : "no") << endl;
+    return 0;
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../Thread_Pool/thread_pool.h"
+
+// Radix sort engine for integer, floating-point and struct keys.
+//
+// A key extractor maps each element to an arithmetic key. The key is encoded
+// as an unsigned integer whose unsigned order matches the key order: signed
+// integers get their sign bit flipped, and IEEE floats flip the sign bit
+// (positive values) or all bits (negative values). Digits are 8 bits wide.
+//
+// - radixSort:         LSD, stable, one scratch buffer, skips constant digits.
+// - parallelRadixSort: LSD with per-thread histograms on a ThreadPool, stable.
+// - msdRadixSort:      MSD in place (American flag sort), not stable.
+namespace radix_sort_detail {
+
+constexpr size_t kRadixBits = 8;
+constexpr size_t kBuckets = size_t(1) << kRadixBits;
+constexpr size_t kPrefetchDistance = 16;
+constexpr ptrdiff_t kMsdInsertionCutoff = 64;
+
+template <typename K, typename Enable = void>
+struct KeyEncoder;
+
+template <typename K>
+struct KeyEncoder<K, std::enable_if_t<std::is_integral<K>::value>> {
+    using Bits = std::conditional_t<(sizeof(K) <= 4), uint32_t, uint64_t>;
+    static constexpr size_t kBytes = sizeof(K);
+    static Bits encode(K k) {
+        using U = std::make_unsigned_t<K>;
+        Bits b = static_cast<U>(k);
+        if (std::is_signed<K>::value) b ^= Bits(1) << (kBytes * 8 - 1);
+        return b;
+    }
+};
+
+template <typename K>
+struct KeyEncoder<K, std::enable_if_t<std::is_floating_point<K>::value>> {
+    static_assert(sizeof(K) == 4 || sizeof(K) == 8, "float or double keys only");
+    using Bits = std::conditional_t<(sizeof(K) == 4), uint32_t, uint64_t>;
+    static constexpr size_t kBytes = sizeof(K);
+    static Bits encode(K k) {
+        Bits b;
+        std::memcpy(&b, &k, sizeof(b));
+        Bits sign = Bits(1) << (kBytes * 8 - 1);
+        return (b & sign) ? ~b : (b | sign);
+    }
+};
+
+struct IdentityKey {
+    template <typename T>
+    T operator()(const T& x) const { return x; }
+};
+
+template <typename T, typename KeyFn>
+using KeyType = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>;
+
+template <typename T, typename KeyFn>
+auto encodeKey(const T& x, KeyFn& key) {
+    return KeyEncoder<KeyType<T, KeyFn>>::encode(key(x));
+}
+
+template <typename Bits>
+size_t digitOf(Bits bits, size_t pass) {
+    return static_cast<size_t>((bits >> (pass * kRadixBits)) & (kBuckets - 1));
+}
+
+// Scatters src into dst by one digit. dst slots are prefetched a few elements
+// ahead, which keeps the 256 write streams from stalling on cache misses.
+template <typename T, typename KeyFn>
+void scatter(T* src, T* dst, size_t begin, size_t end, size_t pass,
+             size_t* offsets, KeyFn& key) {
+    for (size_t i = begin; i < end; ++i) {
+        if (i + kPrefetchDistance < end) {
+            size_t ahead = digitOf(encodeKey(src[i + kPrefetchDistance], key), pass);
+            __builtin_prefetch(dst + offsets[ahead], 1);
+        }
+        size_t d = digitOf(encodeKey(src[i], key), pass);
+        dst[offsets[d]++] = std::move(src[i]);
+    }
+}
+
+template <typename T, typename KeyFn>
+void lsdSort(T* a, T* buf, size_t n, KeyFn& key) {
+    using Encoder = KeyEncoder<KeyType<T, KeyFn>>;
+    constexpr size_t passes = Encoder::kBytes;
+
+    // One read of the input builds the histograms of every digit position.
+    std::vector<std::array<size_t, kBuckets>> counts(passes);
+    for (auto& c : counts) c.fill(0);
+    for (size_t i = 0; i < n; ++i) {
+        auto bits = encodeKey(a[i], key);
+        for (size_t p = 0; p < passes; ++p) ++counts[p][digitOf(bits, p)];
+    }
+
+    T* src = a;
+    T* dst = buf;
+    std::array<size_t, kBuckets> offsets;
+    for (size_t p = 0; p < passes; ++p) {
+        if (counts[p][digitOf(encodeKey(src[0], key), p)] == n) continue; // Constant digit
+        size_t sum = 0;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            offsets[d] = sum;
+            sum += counts[p][d];
+        }
+        scatter(src, dst, 0, n, p, offsets.data(), key);
+        std::swap(src, dst);
+    }
+    if (src != a) std::move(src, src + n, a);
+}
+
+template <typename T, typename KeyFn>
+void parallelLsdSort(T* a, T* buf, size_t n, KeyFn& key, ThreadPool& pool) {
+    using Encoder = KeyEncoder<KeyType<T, KeyFn>>;
+    constexpr size_t passes = Encoder::kBytes;
+    using Histogram = std::array<size_t, kBuckets>;
+
+    size_t blocks = pool.size();
+    if (blocks == 1) {
+        lsdSort(a, buf, n, key);
+        return;
+    }
+    auto bound = [n, blocks](size_t b) { return b * n / blocks; };
+
+    // Totals per digit position, only used to skip constant digits.
+    std::vector<std::vector<Histogram>> local(blocks, std::vector<Histogram>(passes));
+    pool.parallelFor(blocks, [&](size_t b) {
+        for (auto& h : local[b]) h.fill(0);
+        for (size_t i = bound(b); i < bound(b + 1); ++i) {
+            auto bits = encodeKey(a[i], key);
+            for (size_t p = 0; p < passes; ++p) ++local[b][p][digitOf(bits, p)];
+        }
+    });
+    std::vector<bool> skip(passes);
+    size_t activePasses = 0;
+    for (size_t p = 0; p < passes; ++p) {
+        size_t d0 = digitOf(encodeKey(a[0], key), p);
+        size_t total = 0;
+        for (size_t b = 0; b < blocks; ++b) total += local[b][p][d0];
+        skip[p] = total == n;
+        activePasses += skip[p] ? 0 : 1;
+    }
+    if (activePasses == 0) return;
+
+    std::vector<Histogram> hist(blocks);
+    T* src = a;
+    T* dst = buf;
+    for (size_t p = 0; p < passes; ++p) {
+        if (skip[p]) continue;
+        // Blocks of src changed since the first scan, so recount this digit.
+        pool.parallelFor(blocks, [&](size_t b) {
+            hist[b].fill(0);
+            for (size_t i = bound(b); i < bound(b + 1); ++i) ++hist[b][digitOf(encodeKey(src[i], key), p)];
+        });
+        // Block b writes bucket d after all smaller buckets and after the
+        // bucket-d elements of blocks before it, which keeps the sort stable.
+        size_t sum = 0;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            for (size_t b = 0; b < blocks; ++b) {
+                size_t c = hist[b][d];
+                hist[b][d] = sum;
+                sum += c;
+            }
+        }
+        pool.parallelFor(blocks, [&](size_t b) {
+            scatter(src, dst, bound(b), bound(b + 1), p, hist[b].data(), key);
+        });
+        std::swap(src, dst);
+    }
+    if (src != a) {
+        pool.parallelFor(blocks, [&](size_t b) {
+            std::move(src + bound(b), src + bound(b + 1), a + bound(b));
+        });
+    }
+}
+
+template <typename T, typename KeyFn>
+void insertionSortByKey(T* lo, T* hi, KeyFn& key) {
+    for (T* i = lo + 1; i < hi; ++i) {
+        T x = std::move(*i);
+        auto bits = encodeKey(x, key);
+        T* j = i;
+        while (j > lo && bits < encodeKey(*(j - 1), key)) {
+            *j = std::move(*(j - 1));
+            --j;
+        }
+        *j = std::move(x);
+    }
+}
+
+// American flag sort on digit `pass`, then recursion into each bucket on the
+// next lower digit.
+template <typename T, typename KeyFn>
+void msdSort(T* lo, T* hi, size_t pass, KeyFn& key) {
+    for (;;) {
+        if (hi - lo <= kMsdInsertionCutoff) {
+            insertionSortByKey(lo, hi, key);
+            return;
+        }
+        std::array<size_t, kBuckets> count{};
+        for (T* p = lo; p < hi; ++p) ++count[digitOf(encodeKey(*p, key), pass)];
+
+        size_t n = static_cast<size_t>(hi - lo);
+        size_t d0 = digitOf(encodeKey(*lo, key), pass);
+        if (count[d0] == n) {
+            if (pass == 0) return;
+            --pass; // Shared digit, nothing to move
+            continue;
+        }
+
+        std::array<size_t, kBuckets> next, end;
+        size_t sum = 0;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            next[d] = sum;
+            sum += count[d];
+            end[d] = sum;
+        }
+        for (size_t b = 0; b < kBuckets; ++b) {
+            while (next[b] < end[b]) {
+                T x = std::move(lo[next[b]]);
+                size_t d = digitOf(encodeKey(x, key), pass);
+                while (d != b) {
+                    std::swap(x, lo[next[d]++]);
+                    d = digitOf(encodeKey(x, key), pass);
+                }
+                lo[next[b]++] = std::move(x);
+            }
+        }
+        if (pass == 0) return;
+        size_t start = 0;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            if (count[d] > 1) msdSort(lo + start, lo + start + count[d], pass - 1, key);
+            start += count[d];
+        }
+        return;
+    }
+}
+
+} // namespace radix_sort_detail
+
+using radix_sort_detail::IdentityKey;
+
+// Stable LSD radix sort of the contiguous range [first, last) by key(element).
+template <typename RandomIt, typename KeyFn = IdentityKey>
+void radixSort(RandomIt first, RandomIt last, KeyFn key = KeyFn()) {
+    size_t n = static_cast<size_t>(last - first);
+    if (n < 2) return;
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> buf(n);
+    radix_sort_detail::lsdSort(&*first, buf.data(), n, key);
+}
+
+// Stable LSD radix sort using per-thread histograms and parallel scatter.
+template <typename RandomIt, typename KeyFn = IdentityKey>
+void parallelRadixSort(RandomIt first, RandomIt last, KeyFn key = KeyFn(),
+                       ThreadPool& pool = defaultThreadPool()) {
+    size_t n = static_cast<size_t>(last - first);
+    if (n < 2) return;
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> buf(n);
+    radix_sort_detail::parallelLsdSort(&*first, buf.data(), n, key, pool);
+}
+
+// In-place MSD radix sort. Uses no scratch buffer but is not stable.
+template <typename RandomIt, typename KeyFn = IdentityKey>
+void msdRadixSort(RandomIt first, RandomIt last, KeyFn key = KeyFn()) {
+    ptrdiff_t n = last - first;
+    if (n < 2) return;
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    constexpr size_t bytes = radix_sort_detail::KeyEncoder<radix_sort_detail::KeyType<T, KeyFn>>::kBytes;
+    auto* lo = &*first;
+    radix_sort_detail::msdSort(lo, lo + n, bytes - 1, key);
+}
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include "selection_sort.h"
 using namespace std;
 
 void selectionSort(vector<int>& arr) {
@@ -23,6 +25,13 @@ int main() {
     selectionSort(arr);
     cout << "Sorted array: ";
     printArray(arr);
+
+    // Generic version from selection_sort.h, any element type and ordering
+    vector<string> words = {"pear", "apple", "fig", "banana"};
+    selectionSort(words.begin(), words.end(), greater<>());
+    cout << "Words, descending: ";
+    for (const auto& w : words) cout << w << " ";
+    cout << endl;
     return 0;
 }
 
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+
+// Generic selection sort, not stable. Performs at most n - 1 swaps, which is
+// its one advantage when moving elements is expensive.
+template <typename RandomIt, typename Compare = std::less<>>
+void selectionSort(RandomIt first, RandomIt last, Compare cmp = Compare()) {
+    for (RandomIt i = first; last - i > 1; ++i) {
+        RandomIt minIt = i;
+        for (RandomIt j = i + 1; j < last; ++j) {
+            if (cmp(*j, *minIt)) minIt = j;
+        }
+        if (minIt != i) std::iter_swap(minIt, i);
+    }
+}
@@ -0,0 +1,182 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "sorting_benchmark.h"
+using namespace std;
+using namespace sorting_benchmark;
+
+// Every heap allocation in the process goes through here, which is how the
+// benchmark reports allocations per sort call. (GCC flags the malloc/free pair
+// once these are inlined into the containers; the pairing is correct.)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* countedAlloc(size_t size) noexcept {
+    allocations().count.fetch_add(1, memory_order_relaxed);
+    allocations().bytes.fetch_add(size, memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+void* operator new(size_t size) {
+    if (void* p = countedAlloc(size)) return p;
+    throw bad_alloc();
+}
+void* operator new(size_t size, const nothrow_t&) noexcept { return countedAlloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+
+struct Options {
+    vector<size_t> sizes = {16, 256, 4096, 65536, 1048576};
+    vector<string> types = {"int32", "int64", "double", "struct"};
+    vector<string> dists;
+    vector<string> algos;
+    size_t threads = 0; // 0: one per hardware thread
+    size_t quadraticMax = 65536;
+    uint64_t seed = 42;
+    double zipfS = 1.0;
+    string out;
+    RunLimits limits;
+};
+
+vector<string> splitList(const string& s) {
+    vector<string> parts;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) parts.push_back(item);
+    }
+    return parts;
+}
+
+bool contains(const vector<string>& list, const string& name) {
+    return find(list.begin(), list.end(), name) != list.end();
+}
+
+void printUsage() {
+    cerr << "Usage: sorting_benchmark [options]\n"
+         << "  --sizes 16,1000,1e6,1e9     element counts\n"
+         << "  --types int32,int64,double,struct\n"
+         << "  --distributions random,sorted,reversed,sawtooth,few_unique,zipf\n"
+         << "  --algorithms bubble,selection,insertion,merge,parallel_merge,quick,\n"
+         << "               quick_network,radix,parallel_radix,msd_radix,std_sort,std_stable_sort\n"
+         << "  --threads N                 threads for the parallel sorts\n"
+         << "  --quadratic-max N           largest size for bubble/selection/insertion (65536)\n"
+         << "  --count-max N               largest size for counting comparisons/moves (2^24)\n"
+         << "  --min-time SECONDS          sorting time to accumulate per case (0.1)\n"
+         << "  --max-reps N                repetitions per case at most (1000)\n"
+         << "  --zipf-s S                  Zipf exponent (1.0)\n"
+         << "  --seed N                    input seed (42)\n"
+         << "  --out FILE                  write JSON to FILE instead of stdout\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help" || i + 1 >= argc) return false;
+        string value = argv[++i];
+        if (arg == "--sizes") {
+            o.sizes.clear();
+            for (const string& s : splitList(value)) o.sizes.push_back(static_cast<size_t>(stod(s)));
+        } else if (arg == "--types") {
+            o.types = splitList(value);
+        } else if (arg == "--distributions") {
+            o.dists = splitList(value);
+        } else if (arg == "--algorithms") {
+            o.algos = splitList(value);
+        } else if (arg == "--threads") {
+            o.threads = stoul(value);
+        } else if (arg == "--quadratic-max") {
+            o.quadraticMax = static_cast<size_t>(stod(value));
+        } else if (arg == "--count-max") {
+            o.limits.countMax = static_cast<size_t>(stod(value));
+        } else if (arg == "--min-time") {
+            o.limits.minSeconds = stod(value);
+        } else if (arg == "--max-reps") {
+            o.limits.maxReps = stoul(value);
+        } else if (arg == "--zipf-s") {
+            o.zipfS = stod(value);
+        } else if (arg == "--seed") {
+            o.seed = stoull(value);
+        } else if (arg == "--out") {
+            o.out = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+class JsonWriter {
+public:
+    explicit JsonWriter(ostream& out) : out(out) { out << "[\n"; }
+    ~JsonWriter() { out << "\n]\n"; }
+
+    void record(const char* algorithm, const char* type, const char* distribution, size_t n,
+                size_t threads, bool comparisonBased, const Measurement& m) {
+        out << (first ? "" : ",\n") << "  {\"algorithm\": \"" << algorithm << "\", \"type\": \"" << type
+            << "\", \"distribution\": \"" << distribution << "\", \"n\": " << n << ", \"threads\": " << threads
+            << ", \"reps\": " << m.reps << ", \"ns_per_element\": " << m.nsPerElement
+            << ", \"ns_per_element_min\": " << m.nsPerElementMin
+            << ", \"comparisons\": " << (m.counted && comparisonBased ? to_string(m.comparisons) : "null")
+            << ", \"moves\": " << (m.counted ? to_string(m.moves) : "null")
+            << ", \"allocations\": " << m.allocations << ", \"allocated_bytes\": " << m.allocatedBytes
+            << ", \"verified\": " << (m.verified ? "true" : "false") << "}";
+        out.flush();
+        first = false;
+    }
+
+private:
+    ostream& out;
+    bool first = true;
+};
+
+template <typename T>
+void benchmarkType(const Options& o, ThreadPool& serial, ThreadPool& pool, JsonWriter& json) {
+    const char* type = KeyTraits<T>::name;
+    vector<T> input;
+    for (size_t n : o.sizes) {
+        for (const auto& [dist, distName] : distributions()) {
+            if (!o.dists.empty() && !contains(o.dists, distName)) continue;
+            fillInput(input, n, dist, o.seed, o.zipfS);
+            for (const AlgorithmInfo& a : algorithms()) {
+                if (!o.algos.empty() && !contains(o.algos, a.name)) continue;
+                if (a.quadratic && n > o.quadraticMax) continue;
+                cerr << a.name << " " << type << " " << distName << " n=" << n << endl;
+                Measurement m = measure(a.id, a.countable, input, DefaultCompare<T>(), serial, pool, o.limits);
+                json.record(a.name, type, distName, n, a.parallel ? pool.size() : 1, a.comparisonBased, m);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        printUsage();
+        return 1;
+    }
+
+    ThreadPool serial(1);
+    ThreadPool pool(o.threads ? o.threads : thread::hardware_concurrency());
+    ofstream file;
+    if (!o.out.empty()) {
+        file.open(o.out);
+        if (!file) {
+            cerr << "Cannot open " << o.out << endl;
+            return 1;
+        }
+    }
+    ostream& out = o.out.empty() ? cout : file;
+    out.precision(4);
+
+    JsonWriter json(out);
+    if (contains(o.types, "int32")) benchmarkType<int32_t>(o, serial, pool, json);
+    if (contains(o.types, "int64")) benchmarkType<int64_t>(o, serial, pool, json);
+    if (contains(o.types, "double")) benchmarkType<double>(o, serial, pool, json);
+    if (contains(o.types, "struct")) benchmarkType<Record>(o, serial, pool, json);
+    return 0;
+}
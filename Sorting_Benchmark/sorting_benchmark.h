@@ -0,0 +1,324 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../Bubble_Sort/bubble_sort.h"
+#include "../Insertion_Sort/insertion_sort.h"
+#include "../Merge_Sort/merge_sort.h"
+#include "../Quick_Sort/quick_sort.h"
+#include "../Radix_Sort/radix_sort.h"
+#include "../Selection_Sort/selection_sort.h"
+#include "../Sorting_Network/sorting_network.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Building blocks of the sorting benchmark: input distributions, key types,
+// the list of sorts, and instrumentation.
+//
+// Every case is measured twice. The timed run sorts the plain key type with
+// the plain comparator, so instrumentation cannot distort ns/element; it also
+// counts heap allocations (through the global operator new override in
+// sorting_benchmark.cpp). The counting run sorts Counted<T>, whose copies and
+// moves bump a counter, with a comparator that counts its calls.
+namespace sorting_benchmark {
+
+enum class Distribution { Random, Sorted, Reversed, Sawtooth, FewUnique, Zipf };
+
+enum class Algorithm {
+    Bubble, Selection, Insertion, Merge, ParallelMerge, Quick, QuickNetwork,
+    Radix, ParallelRadix, MsdRadix, StdSort, StdStableSort
+};
+
+inline const std::vector<std::pair<Distribution, const char*>>& distributions() {
+    static const std::vector<std::pair<Distribution, const char*>> list = {
+        {Distribution::Random, "random"},       {Distribution::Sorted, "sorted"},
+        {Distribution::Reversed, "reversed"},   {Distribution::Sawtooth, "sawtooth"},
+        {Distribution::FewUnique, "few_unique"}, {Distribution::Zipf, "zipf"}};
+    return list;
+}
+
+struct AlgorithmInfo {
+    Algorithm id;
+    const char* name;
+    bool quadratic;        // Skipped above the --quadratic-max size
+    bool parallel;         // Uses the benchmark's thread pool
+    bool comparisonBased;  // Radix sorts never call the comparator
+    bool countable;        // Runs unchanged on Counted<T>
+};
+
+inline const std::vector<AlgorithmInfo>& algorithms() {
+    static const std::vector<AlgorithmInfo> list = {
+        {Algorithm::Bubble, "bubble", true, false, true, true},
+        {Algorithm::Selection, "selection", true, false, true, true},
+        {Algorithm::Insertion, "insertion", true, false, true, true},
+        {Algorithm::Merge, "merge", false, false, true, true},
+        {Algorithm::ParallelMerge, "parallel_merge", false, true, true, true},
+        {Algorithm::Quick, "quick", false, false, true, true},
+        // The network leaf only applies to plain int32/float keys, so counts
+        // on Counted<T> would describe the insertion sort fallback instead.
+        {Algorithm::QuickNetwork, "quick_network", false, false, true, false},
+        {Algorithm::Radix, "radix", false, false, false, true},
+        {Algorithm::ParallelRadix, "parallel_radix", false, true, false, true},
+        {Algorithm::MsdRadix, "msd_radix", false, false, false, true},
+        {Algorithm::StdSort, "std_sort", false, false, true, true},
+        {Algorithm::StdStableSort, "std_stable_sort", false, false, true, true}};
+    return list;
+}
+
+// ---------------------------------------------------------------------------
+// Key types
+
+// A 32-byte record sorted by its key, standing in for "sort structs by a field".
+struct Record {
+    int64_t key;
+    uint64_t payload[3];
+};
+
+template <typename T>
+struct KeyTraits;
+
+template <>
+struct KeyTraits<int32_t> {
+    static constexpr const char* name = "int32";
+    static int32_t make(uint64_t v) { return static_cast<int32_t>(static_cast<uint32_t>(v)); }
+    static int32_t key(int32_t x) { return x; }
+};
+
+template <>
+struct KeyTraits<int64_t> {
+    static constexpr const char* name = "int64";
+    static int64_t make(uint64_t v) { return static_cast<int64_t>(v); }
+    static int64_t key(int64_t x) { return x; }
+};
+
+template <>
+struct KeyTraits<double> {
+    static constexpr const char* name = "double";
+    static double make(uint64_t v) { return std::ldexp(static_cast<double>(static_cast<int64_t>(v)), -20); }
+    static double key(double x) { return x; }
+};
+
+template <>
+struct KeyTraits<Record> {
+    static constexpr const char* name = "struct";
+    static Record make(uint64_t v) { return Record{static_cast<int64_t>(v), {v, v, v}}; }
+    static int64_t key(const Record& r) { return r.key; }
+};
+
+// ---------------------------------------------------------------------------
+// Inputs
+
+// Values for "random" span the whole 64-bit range; the others are small
+// integers that every key type represents exactly. Sawtooth is 16 ascending
+// runs, few-unique draws from 16 values, and Zipf draws ranks 1..n with
+// P(rank) ~ 1 / rank^s by inverting the continuous CDF.
+template <typename T>
+void fillInput(std::vector<T>& out, size_t n, Distribution dist, uint64_t seed, double zipfS = 1.0) {
+    out.resize(n);
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    size_t period = std::max<size_t>(2, n / 16);
+    double universe = static_cast<double>(n) + 1;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v = 0;
+        switch (dist) {
+        case Distribution::Random: v = rng(); break;
+        case Distribution::Sorted: v = i; break;
+        case Distribution::Reversed: v = n - i; break;
+        case Distribution::Sawtooth: v = i % period; break;
+        case Distribution::FewUnique: v = rng() % 16; break;
+        case Distribution::Zipf: {
+            double u = uniform(rng);
+            double x = zipfS == 1.0
+                ? std::exp(u * std::log(universe))
+                : std::pow(u * (std::pow(universe, 1 - zipfS) - 1) + 1, 1 / (1 - zipfS));
+            v = std::min<uint64_t>(n, std::max<uint64_t>(1, static_cast<uint64_t>(x)));
+            break;
+        }
+        }
+        out[i] = KeyTraits<T>::make(v);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Instrumentation
+
+struct OperationCounters {
+    std::atomic<uint64_t> comparisons{0};
+    std::atomic<uint64_t> moves{0};
+    void reset() {
+        comparisons = 0;
+        moves = 0;
+    }
+};
+
+inline OperationCounters& counters() {
+    static OperationCounters c;
+    return c;
+}
+
+// Heap allocations since the last reset; maintained by operator new.
+struct AllocationCounters {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> bytes{0};
+    void reset() {
+        count = 0;
+        bytes = 0;
+    }
+};
+
+inline AllocationCounters& allocations() {
+    static AllocationCounters c;
+    return c;
+}
+
+// Wrapper whose copies and moves (constructions and assignments) are counted.
+template <typename T>
+struct Counted {
+    T value;
+
+    Counted() = default;
+    explicit Counted(const T& v) : value(v) {}
+    Counted(const Counted& o) : value(o.value) { tick(); }
+    Counted(Counted&& o) noexcept : value(std::move(o.value)) { tick(); }
+    Counted& operator=(const Counted& o) {
+        value = o.value;
+        tick();
+        return *this;
+    }
+    Counted& operator=(Counted&& o) noexcept {
+        value = std::move(o.value);
+        tick();
+        return *this;
+    }
+
+private:
+    static void tick() { counters().moves.fetch_add(1, std::memory_order_relaxed); }
+};
+
+template <typename Compare>
+struct CountingCompare {
+    Compare cmp;
+    template <typename T>
+    bool operator()(const Counted<T>& a, const Counted<T>& b) const {
+        counters().comparisons.fetch_add(1, std::memory_order_relaxed);
+        return cmp(a.value, b.value);
+    }
+};
+
+template <typename T>
+struct KeyOf {
+    auto operator()(const T& x) const { return KeyTraits<T>::key(x); }
+};
+
+template <typename T>
+struct KeyOf<Counted<T>> {
+    auto operator()(const Counted<T>& x) const { return KeyTraits<T>::key(x.value); }
+};
+
+template <typename T>
+struct LessOf {
+    bool operator()(const T& a, const T& b) const { return KeyTraits<T>::key(a) < KeyTraits<T>::key(b); }
+};
+
+// std::less<> for arithmetic keys, which is what lets NetworkLeafSort kick in.
+template <typename T>
+using DefaultCompare = std::conditional_t<std::is_arithmetic<T>::value, std::less<>, LessOf<T>>;
+
+// ---------------------------------------------------------------------------
+// Running one sort
+
+// `serial` is a one-thread pool so "merge" measures the engine without
+// parallelism; `pool` is used by the parallel variants.
+template <typename T, typename Compare>
+void runSort(Algorithm algorithm, std::vector<T>& v, Compare cmp, ThreadPool& serial, ThreadPool& pool) {
+    auto first = v.begin(), last = v.end();
+    KeyOf<T> key;
+    switch (algorithm) {
+    case Algorithm::Bubble: bubbleSort(first, last, cmp); break;
+    case Algorithm::Selection: selectionSort(first, last, cmp); break;
+    case Algorithm::Insertion: insertionSort(first, last, cmp); break;
+    case Algorithm::Merge: parallelMergeSort(first, last, cmp, serial); break;
+    case Algorithm::ParallelMerge: parallelMergeSort(first, last, cmp, pool); break;
+    case Algorithm::Quick: introSort(first, last, cmp); break;
+    case Algorithm::QuickNetwork: introSort<NetworkLeafSort>(first, last, cmp); break;
+    case Algorithm::Radix: radixSort(first, last, key); break;
+    case Algorithm::ParallelRadix: parallelRadixSort(first, last, key, pool); break;
+    case Algorithm::MsdRadix: msdRadixSort(first, last, key); break;
+    case Algorithm::StdSort: std::sort(first, last, cmp); break;
+    case Algorithm::StdStableSort: std::stable_sort(first, last, cmp); break;
+    }
+}
+
+struct Measurement {
+    size_t reps = 0;
+    double nsPerElement = 0;     // Median over reps
+    double nsPerElementMin = 0;
+    uint64_t allocations = 0;    // Of a single sort call
+    uint64_t allocatedBytes = 0;
+    bool verified = false;
+    bool counted = false;
+    uint64_t comparisons = 0;
+    uint64_t moves = 0;
+};
+
+struct RunLimits {
+    double minSeconds = 0.1;   // Repeat until this much sorting time is measured
+    size_t maxReps = 1000;
+    size_t countMax = size_t(1) << 24; // Largest n for the counting run
+};
+
+// Times `algorithm` on copies of `input` and, for small enough inputs, repeats
+// it once on Counted<T> to count comparisons and moves.
+template <typename T, typename Compare>
+Measurement measure(Algorithm algorithm, bool countable, const std::vector<T>& input, Compare cmp,
+                    ThreadPool& serial, ThreadPool& pool, const RunLimits& limits) {
+    Measurement m;
+    size_t n = input.size();
+    std::vector<T> work(n);
+    std::vector<double> times;
+    double total = 0;
+    while (m.reps < std::max<size_t>(1, limits.maxReps) && (m.reps == 0 || total < limits.minSeconds)) {
+        std::copy(input.begin(), input.end(), work.begin());
+        allocations().reset();
+        auto start = std::chrono::steady_clock::now();
+        runSort(algorithm, work, cmp, serial, pool);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (m.reps == 0) {
+            m.allocations = allocations().count;
+            m.allocatedBytes = allocations().bytes;
+            m.verified = std::is_sorted(work.begin(), work.end(), cmp);
+        }
+        times.push_back(seconds);
+        total += seconds;
+        ++m.reps;
+    }
+    std::sort(times.begin(), times.end());
+    double perElement = 1e9 / static_cast<double>(std::max<size_t>(1, n));
+    m.nsPerElement = times[times.size() / 2] * perElement;
+    m.nsPerElementMin = times.front() * perElement;
+
+    if (countable && n <= limits.countMax) {
+        std::vector<T>().swap(work);
+        std::vector<Counted<T>> counted;
+        counted.reserve(n);
+        for (const T& x : input) counted.emplace_back(x);
+        counters().reset();
+        runSort(algorithm, counted, CountingCompare<Compare>{cmp}, serial, pool);
+        m.counted = true;
+        m.comparisons = counters().comparisons;
+        m.moves = counters().moves;
+    }
+    return m;
+}
+
+} // namespace sorting_benchmark
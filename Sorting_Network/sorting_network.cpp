@@ -0,0 +1,74 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "sorting_network.h"
+#include "../Quick_Sort/quick_sort.h"
+#include "../Merge_Sort/merge_sort.h"
+using namespace std;
+
+const char* levelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE41: return "SSE4.1";
+        default: return "Scalar";
+    }
+}
+
+template <typename Fn>
+double timeMs(Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    vector<int32_t> arr = {12, 11, 13, 5, 6, 7, -4, 0, 42, 3};
+    smallSort(arr.data(), arr.size());
+    cout << "Sorted array: ";
+    for (int x : arr) cout << x << " ";
+    cout << endl;
+    cout << "Detected kernel family: " << levelName(detectSimdLevel()) << endl;
+
+    // Leaf-sized blocks, the shape merge and quick sort hand to the leaf sort
+    const size_t blocks = 200000;
+    mt19937 rng(1);
+    vector<int32_t> input(blocks * 32);
+    for (auto& x : input) x = int32_t(rng());
+
+    vector<int32_t> expected = input;
+    double insertionMs = timeMs([&] {
+        for (size_t b = 0; b < blocks; ++b) insertionSort(&expected[b * 32], &expected[b * 32 + 32]);
+    });
+    cout << "Sorting " << blocks << " blocks of 32 keys:\n";
+    cout << "  insertion sort: " << insertionMs << " ms\n";
+
+    vector<SimdLevel> levels = {SimdLevel::Scalar};
+    if (detectSimdLevel() >= SimdLevel::SSE41) levels.push_back(SimdLevel::SSE41);
+    if (detectSimdLevel() >= SimdLevel::AVX2) levels.push_back(SimdLevel::AVX2);
+    for (SimdLevel level : levels) {
+        vector<int32_t> data = input;
+        double ms = timeMs([&] {
+            for (size_t b = 0; b < blocks; ++b) sortingNetwork(&data[b * 32], 32, level);
+        });
+        cout << "  " << levelName(level) << " network: " << ms << " ms"
+             << (data == expected ? "" : " (MISMATCH)") << "\n";
+    }
+
+    // Plugged into the engines as their leaf sort
+    vector<int32_t> keys(5000000);
+    for (auto& x : keys) x = int32_t(rng());
+    vector<int32_t> a = keys, b = keys, c = keys, d = keys;
+    cout << "Sorting " << keys.size() << " keys:\n";
+    cout << "  introSort, insertion leaves:         " << timeMs([&] { introSort(a.begin(), a.end()); }) << " ms\n";
+    cout << "  introSort, network leaves:           "
+         << timeMs([&] { introSort<NetworkLeafSort>(b.begin(), b.end()); }) << " ms\n";
+    cout << "  parallelMergeSort, insertion leaves: "
+         << timeMs([&] { parallelMergeSort(c.begin(), c.end()); }) << " ms\n";
+    cout << "  parallelMergeSort, network leaves:   "
+         << timeMs([&] { parallelMergeSort<NetworkLeafSort>(d.begin(), d.end()); }) << " ms\n";
+    cout << "Results match: " << (a == b && a == c && a == d ? "yes" : "no") << endl;
+    return 0;
+}
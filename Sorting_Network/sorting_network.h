@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SORTING_NETWORK_X86 1
+#endif
+
+#include "../Insertion_Sort/insertion_sort.h"
+
+// Bitonic sorting networks for small arrays of int32_t or float keys.
+//
+// Kernels sort exactly 8, 16, 32 or 64 keys. The network is written in the
+// "no direction" form: for each block size k, element i is first compared with
+// its mirror i ^ (k - 1), then with i ^ j for j = k/4, ..., 1. Every
+// compare-exchange puts the minimum at the lower index, so a whole step is one
+// vector min and one vector max. Steps with a stride smaller than the vector
+// width permute lanes inside a register and blend the min/max halves.
+//
+// AVX2 (8 lanes) and SSE4.1 (4 lanes) kernels are compiled with target
+// pragmas, so no special compiler flags are needed; the best one the CPU
+// supports is chosen at runtime, with a scalar branch-free network as the
+// fallback. Keys must not be NaN.
+enum class SimdLevel { Scalar, SSE41, AVX2 };
+
+namespace sorting_network_detail {
+
+constexpr size_t kMaxNetworkSize = 64;
+
+// Network over N keys held in N / Ops::kLanes vectors. Ops supplies load/store,
+// minv/maxv, reverse, exchangeInLane(v, j) (partner i ^ j) and mirrorInLane(v, k)
+// (partner i ^ (k - 1)). The body is expanded once per target region because
+// AVX2 and SSE code cannot share one inlined function.
+#define SORTING_NETWORK_BODY                                                           \
+    constexpr size_t W = Ops::kLanes;                                                  \
+    constexpr size_t V = N / W;                                                        \
+    typename Ops::Vec r[V];                                                            \
+    for (size_t v = 0; v < V; ++v) r[v] = Ops::load(a + v * W);                        \
+    for (size_t k = 2; k <= N; k *= 2) {                                               \
+        if (k <= W) {                                                                  \
+            for (size_t v = 0; v < V; ++v) r[v] = Ops::mirrorInLane(r[v], k);          \
+        } else {                                                                       \
+            size_t kv = k / W;                                                         \
+            for (size_t base = 0; base < V; base += kv) {                              \
+                for (size_t x = 0; x < kv / 2; ++x) {                                  \
+                    size_t p = base + kv - 1 - x;                                      \
+                    auto partner = Ops::reverse(r[p]);                                 \
+                    auto lo = Ops::minv(r[base + x], partner);                         \
+                    auto hi = Ops::maxv(r[base + x], partner);                         \
+                    r[base + x] = lo;                                                  \
+                    r[p] = Ops::reverse(hi);                                           \
+                }                                                                      \
+            }                                                                          \
+        }                                                                              \
+        for (size_t j = k / 4; j >= 1; j /= 2) {                                       \
+            if (j < W) {                                                               \
+                for (size_t v = 0; v < V; ++v) r[v] = Ops::exchangeInLane(r[v], j);    \
+            } else {                                                                   \
+                size_t jv = j / W;                                                     \
+                for (size_t v = 0; v < V; ++v) {                                       \
+                    if (v & jv) continue;                                              \
+                    auto lo = Ops::minv(r[v], r[v + jv]);                              \
+                    auto hi = Ops::maxv(r[v], r[v + jv]);                              \
+                    r[v] = lo;                                                         \
+                    r[v + jv] = hi;                                                    \
+                }                                                                      \
+            }                                                                          \
+        }                                                                              \
+    }                                                                                  \
+    for (size_t v = 0; v < V; ++v) Ops::store(a + v * W, r[v]);
+
+template <typename T>
+struct ScalarOps {
+    static constexpr size_t kLanes = 1;
+    using Vec = T;
+    static Vec load(const T* p) { return *p; }
+    static void store(T* p, Vec v) { *p = v; }
+    static Vec minv(Vec a, Vec b) { return b < a ? b : a; }
+    static Vec maxv(Vec a, Vec b) { return b < a ? a : b; }
+    static Vec reverse(Vec v) { return v; }
+    static Vec mirrorInLane(Vec v, size_t) { return v; }
+    static Vec exchangeInLane(Vec v, size_t) { return v; }
+};
+
+template <size_t N, typename T>
+void scalarNetwork(T* a) {
+    using Ops = ScalarOps<T>;
+    SORTING_NETWORK_BODY
+}
+
+#ifdef SORTING_NETWORK_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+
+template <typename T>
+struct Sse41Ops;
+
+// 4 lanes. Lane permutations use shuffle immediates; blend masks pick the
+// maximum for the lanes whose index has the stride bit set.
+template <>
+struct Sse41Ops<float> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m128;
+    static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+    static Vec minv(Vec a, Vec b) { return _mm_min_ps(a, b); }
+    static Vec maxv(Vec a, Vec b) { return _mm_max_ps(a, b); }
+    static Vec reverse(Vec v) { return _mm_shuffle_ps(v, v, 0x1B); }
+    static Vec combine(Vec v, Vec w, int stride) {
+        Vec lo = minv(v, w), hi = maxv(v, w);
+        return stride == 1 ? _mm_blend_ps(lo, hi, 0xA) : _mm_blend_ps(lo, hi, 0xC);
+    }
+    static Vec exchangeInLane(Vec v, size_t j) {
+        Vec w = j == 1 ? _mm_shuffle_ps(v, v, 0xB1) : _mm_shuffle_ps(v, v, 0x4E);
+        return combine(v, w, static_cast<int>(j));
+    }
+    static Vec mirrorInLane(Vec v, size_t k) {
+        Vec w = k == 2 ? _mm_shuffle_ps(v, v, 0xB1) : reverse(v);
+        return combine(v, w, static_cast<int>(k / 2));
+    }
+};
+
+template <>
+struct Sse41Ops<int32_t> {
+    static constexpr size_t kLanes = 4;
+    using Vec = __m128i;
+    static Vec load(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(int32_t* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec minv(Vec a, Vec b) { return _mm_min_epi32(a, b); }
+    static Vec maxv(Vec a, Vec b) { return _mm_max_epi32(a, b); }
+    static Vec reverse(Vec v) { return _mm_shuffle_epi32(v, 0x1B); }
+    static Vec combine(Vec v, Vec w, int stride) {
+        Vec lo = minv(v, w), hi = maxv(v, w);
+        return stride == 1 ? _mm_blend_epi16(lo, hi, 0xCC) : _mm_blend_epi16(lo, hi, 0xF0);
+    }
+    static Vec exchangeInLane(Vec v, size_t j) {
+        Vec w = j == 1 ? _mm_shuffle_epi32(v, 0xB1) : _mm_shuffle_epi32(v, 0x4E);
+        return combine(v, w, static_cast<int>(j));
+    }
+    static Vec mirrorInLane(Vec v, size_t k) {
+        Vec w = k == 2 ? _mm_shuffle_epi32(v, 0xB1) : reverse(v);
+        return combine(v, w, static_cast<int>(k / 2));
+    }
+};
+
+template <size_t N, typename T>
+void sse41Network(T* a) {
+    using Ops = Sse41Ops<T>;
+    SORTING_NETWORK_BODY
+}
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+template <typename T>
+struct Avx2Ops;
+
+// 8 lanes. Lane permutations use permutevar8x32 with constant index vectors.
+struct Avx2Permutes {
+    static __m256i swap1() { return _mm256_setr_epi32(1, 0, 3, 2, 5, 4, 7, 6); }
+    static __m256i swap2() { return _mm256_setr_epi32(2, 3, 0, 1, 6, 7, 4, 5); }
+    static __m256i swap4() { return _mm256_setr_epi32(4, 5, 6, 7, 0, 1, 2, 3); }
+    static __m256i mirror4() { return _mm256_setr_epi32(3, 2, 1, 0, 7, 6, 5, 4); }
+    static __m256i reverse8() { return _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0); }
+    static __m256i exchange(size_t j) { return j == 1 ? swap1() : j == 2 ? swap2() : swap4(); }
+    static __m256i mirror(size_t k) { return k == 2 ? swap1() : k == 4 ? mirror4() : reverse8(); }
+};
+
+template <>
+struct Avx2Ops<float> {
+    static constexpr size_t kLanes = 8;
+    using Vec = __m256;
+    static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static Vec minv(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    static Vec maxv(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static Vec permute(Vec v, __m256i idx) { return _mm256_permutevar8x32_ps(v, idx); }
+    static Vec reverse(Vec v) { return permute(v, Avx2Permutes::reverse8()); }
+    static Vec combine(Vec v, Vec w, size_t stride) {
+        Vec lo = minv(v, w), hi = maxv(v, w);
+        if (stride == 1) return _mm256_blend_ps(lo, hi, 0xAA);
+        if (stride == 2) return _mm256_blend_ps(lo, hi, 0xCC);
+        return _mm256_blend_ps(lo, hi, 0xF0);
+    }
+    static Vec exchangeInLane(Vec v, size_t j) { return combine(v, permute(v, Avx2Permutes::exchange(j)), j); }
+    static Vec mirrorInLane(Vec v, size_t k) { return combine(v, permute(v, Avx2Permutes::mirror(k)), k / 2); }
+};
+
+template <>
+struct Avx2Ops<int32_t> {
+    static constexpr size_t kLanes = 8;
+    using Vec = __m256i;
+    static Vec load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int32_t* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Vec minv(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+    static Vec maxv(Vec a, Vec b) { return _mm256_max_epi32(a, b); }
+    static Vec permute(Vec v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+    static Vec reverse(Vec v) { return permute(v, Avx2Permutes::reverse8()); }
+    static Vec combine(Vec v, Vec w, size_t stride) {
+        Vec lo = minv(v, w), hi = maxv(v, w);
+        if (stride == 1) return _mm256_blend_epi32(lo, hi, 0xAA);
+        if (stride == 2) return _mm256_blend_epi32(lo, hi, 0xCC);
+        return _mm256_blend_epi32(lo, hi, 0xF0);
+    }
+    static Vec exchangeInLane(Vec v, size_t j) { return combine(v, permute(v, Avx2Permutes::exchange(j)), j); }
+    static Vec mirrorInLane(Vec v, size_t k) { return combine(v, permute(v, Avx2Permutes::mirror(k)), k / 2); }
+};
+
+template <size_t N, typename T>
+void avx2Network(T* a) {
+    using Ops = Avx2Ops<T>;
+    SORTING_NETWORK_BODY
+}
+
+#pragma GCC pop_options
+
+#endif // SORTING_NETWORK_X86
+
+#undef SORTING_NETWORK_BODY
+
+template <typename T>
+using Kernel = void (*)(T*);
+
+// Kernel table indexed by log2(size) - 3, i.e. sizes 8, 16, 32, 64.
+template <typename T>
+const Kernel<T>* kernels(SimdLevel level) {
+    static const Kernel<T> scalar[] = {scalarNetwork<8, T>, scalarNetwork<16, T>,
+                                       scalarNetwork<32, T>, scalarNetwork<64, T>};
+#ifdef SORTING_NETWORK_X86
+    static const Kernel<T> sse[] = {sse41Network<8, T>, sse41Network<16, T>,
+                                    sse41Network<32, T>, sse41Network<64, T>};
+    static const Kernel<T> avx[] = {avx2Network<8, T>, avx2Network<16, T>,
+                                    avx2Network<32, T>, avx2Network<64, T>};
+    if (level == SimdLevel::AVX2) return avx;
+    if (level == SimdLevel::SSE41) return sse;
+#endif
+    (void)level;
+    return scalar;
+}
+
+template <typename T>
+struct IsNetworkKey : std::integral_constant<bool, std::is_same<T, int32_t>::value ||
+                                                       std::is_same<T, float>::value> {};
+
+template <typename T, typename Compare>
+struct IsAscending : std::integral_constant<bool, std::is_same<Compare, std::less<>>::value ||
+                                                      std::is_same<Compare, std::less<T>>::value> {};
+
+} // namespace sorting_network_detail
+
+// Best kernel family supported by this CPU, detected once.
+inline SimdLevel detectSimdLevel() {
+#ifdef SORTING_NETWORK_X86
+    __builtin_cpu_init();
+    static const SimdLevel level = __builtin_cpu_supports("avx2")     ? SimdLevel::AVX2
+                                   : __builtin_cpu_supports("sse4.1") ? SimdLevel::SSE41
+                                                                      : SimdLevel::Scalar;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// Sorts exactly `size` keys in place; size must be 8, 16, 32 or 64.
+template <typename T>
+void sortingNetwork(T* a, size_t size, SimdLevel level = detectSimdLevel()) {
+    static_assert(sorting_network_detail::IsNetworkKey<T>::value, "int32_t or float keys only");
+    size_t index = size == 8 ? 0 : size == 16 ? 1 : size == 32 ? 2 : 3;
+    sorting_network_detail::kernels<T>(level)[index](a);
+}
+
+// Sorts up to 64 keys by padding them with +max to the next network size.
+template <typename T>
+void smallSort(T* a, size_t n, SimdLevel level = detectSimdLevel()) {
+    static_assert(sorting_network_detail::IsNetworkKey<T>::value, "int32_t or float keys only");
+    if (n < 2) return;
+    size_t size = 8;
+    while (size < n) size *= 2;
+    if (size == n) {
+        sortingNetwork(a, size, level);
+        return;
+    }
+    T padded[sorting_network_detail::kMaxNetworkSize];
+    std::memcpy(padded, a, n * sizeof(T));
+    const T pad = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                        : std::numeric_limits<T>::max();
+    std::fill(padded + n, padded + size, pad);
+    sortingNetwork(padded, size, level);
+    std::memcpy(a, padded, n * sizeof(T));
+}
+
+// Leaf sort policy for introSort and parallelMergeSort. int32_t and float
+// keys sorted with std::less go through the networks; anything else falls
+// back to insertion sort.
+struct NetworkLeafSort {
+    static constexpr size_t kMaxLeafSize = sorting_network_detail::kMaxNetworkSize;
+
+    template <typename T, typename Compare>
+    static void sort(T* lo, T* hi, Compare& cmp) {
+        if constexpr (sorting_network_detail::IsNetworkKey<T>::value &&
+                      sorting_network_detail::IsAscending<T, Compare>::value) {
+            smallSort(lo, static_cast<size_t>(hi - lo));
+        } else {
+            InsertionLeafSort::sort(lo, hi, cmp);
+        }
+    }
+};
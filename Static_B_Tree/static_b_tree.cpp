@@ -0,0 +1,95 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <sys/resource.h>
+#include "static_b_tree.h"
+#include "../Jump_Search/jump_search.h"
+using namespace std;
+
+// Major page faults (pages read from disk) of this process so far.
+long majorFaults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_majflt;
+}
+
+// Drops a mapped file from this process and from the page cache, so the next
+// accesses go to disk.
+void evict(const string& path, const void* mapped, size_t bytes) {
+    madvise(const_cast<void*>(mapped), bytes, MADV_DONTNEED);
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return;
+    posix_fadvise(fileno(f), 0, 0, POSIX_FADV_DONTNEED);
+    fclose(f);
+}
+
+int main() {
+    const string dataPath = "static_b_tree_demo.dat", indexPath = "static_b_tree_demo.idx";
+    const size_t n = size_t(1) << 25; // 256 MB of int64 keys
+    const size_t queries = 1 << 20, coldQueries = 2000;
+
+    // A sorted data file, as External_Merge_Sort would write it
+    mt19937_64 rng(7);
+    vector<int64_t> keys(n);
+    for (auto& k : keys) k = static_cast<int64_t>(rng() >> 1);
+    sort(keys.begin(), keys.end());
+    {
+        FILE* f = fopen(dataPath.c_str(), "wb");
+        fwrite(keys.data(), sizeof(int64_t), n, f);
+        fclose(f);
+    }
+    vector<int64_t> probes(queries);
+    for (auto& q : probes) q = rng() % 2 ? keys[rng() % n] : static_cast<int64_t>(rng() >> 1);
+    vector<size_t> expected(queries);
+    for (size_t i = 0; i < queries; ++i) expected[i] = lower_bound(keys.begin(), keys.end(), probes[i]) - keys.begin();
+    keys = vector<int64_t>(); // From here on, only the files are used
+
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    auto start = chrono::steady_clock::now();
+    StaticBTree<int64_t>::build(dataPath, indexPath);
+    double buildMs = since(start);
+    start = chrono::steady_clock::now();
+    StaticBTree<int64_t> tree(dataPath, indexPath);
+    double openMs = since(start);
+    cout << "Index over " << tree.size() << " keys: built in " << buildMs << " ms, opened in " << openMs << " ms, "
+         << tree.levels() << " index levels" << endl;
+
+    // Warm lookups: everything is in the page cache
+    vector<size_t> single(queries), batch(queries);
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < queries; ++i) single[i] = tree.lowerBound(probes[i]);
+    double singleNs = since(start) * 1e6 / queries;
+    start = chrono::steady_clock::now();
+    interleavedSearch(tree, probes.data(), queries, batch.data(), 16);
+    double batchNs = since(start) * 1e6 / queries;
+    cout << "Warm lookups (ns per lookup): one at a time " << singleNs << ", interleaved " << batchNs << endl;
+    cout << "Results match std::lower_bound: " << (single == expected && batch == expected ? "yes" : "no") << endl;
+
+    // Cold lookups: the data file is dropped from the page cache before each
+    // method, and the pages read from disk are counted
+    const int64_t* data = tree.data();
+    auto cold = [&](const char* name, auto&& lookup) {
+        evict(dataPath, data, n * sizeof(int64_t));
+        long faults = majorFaults();
+        bool ok = true;
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < coldQueries; ++i) ok = lookup(probes[i]) == expected[i] && ok;
+        double us = since(start) * 1e3 / coldQueries;
+        cout << "  " << name << (majorFaults() - faults) / double(coldQueries) << " pages, " << us << " us"
+             << (ok ? "" : " (wrong results)") << endl;
+    };
+    cout << "Cold lookups (pages read and time per lookup):" << endl;
+    cold("static B-tree:    ", [&](int64_t x) { return tree.lowerBound(x); });
+    cold("std::lower_bound: ", [&](int64_t x) { return size_t(lower_bound(data, data + n, x) - data); });
+    cold("jump search:      ", [&](int64_t x) { return jumpLowerBound(data, n, x); });
+
+    remove(dataPath.c_str());
+    remove(indexPath.c_str());
+    return 0;
+}
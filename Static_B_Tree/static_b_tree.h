@@ -0,0 +1,354 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Binary_Search/binary_search.h"
+
+// Read-only static B+-tree (S-tree) over a sorted file of fixed-width
+// records, e.g. the output of External_Merge_Sort. Neither file is loaded:
+// both are memory-mapped, so opening a table of any size takes a few system
+// calls, and the OS pages in only what the lookups touch.
+//
+// The data file itself holds the leaves: leaf i is records [i * F, i * F + F),
+// where F = pageSize / sizeof(T). The index file stores the levels above
+// them. Every entry is the largest key of one node of the level below, and
+// every internal node is F entries in one aligned page. Children are found by
+// arithmetic (node j's children are nodes j * F ... j * F + F - 1), so the
+// index needs no pointers and is about 1 / F of the data size.
+//
+// With 4 KB pages and 8-byte keys, F = 512: a 50 GB table has three index
+// levels of 98 MB, 190 KB and one page. The top levels stay cached, so a cold
+// lookup reads one index page and one data page (two if a leaf straddles a
+// page boundary). Inside a page the search is the branchless lowerBound.
+//
+// Files are in native byte order. POSIX only (mmap).
+namespace static_b_tree_detail {
+
+constexpr char kMagic[8] = {'S', 'B', 'T', 'R', 'E', 'E', '1', '\0'};
+constexpr size_t kMaxLevels = 16;
+
+struct Header {
+    char magic[8];
+    uint64_t keySize;
+    uint64_t count;     // Records in the data file
+    uint64_t pageSize;
+    uint64_t fanout;
+    uint64_t levels;
+    uint64_t levelOffset[kMaxLevels]; // Bytes from the start of the index file; level 0 is the root
+    uint64_t levelSize[kMaxLevels];   // Entries
+};
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("static B-tree: cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("static B-tree: cannot stat " + path);
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        if (bytes == 0) return;
+        void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("static B-tree: cannot map " + path);
+        }
+        base = static_cast<const char*>(p);
+    }
+
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        MappedFile(std::move(other)).swap(*this);
+        return *this;
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (base) ::munmap(const_cast<char*>(base), bytes);
+        if (fd >= 0) ::close(fd);
+    }
+
+    const char* data() const { return base; }
+    size_t size() const { return bytes; }
+    int descriptor() const { return fd; }
+
+    void advise(int advice) const {
+        if (base) ::madvise(const_cast<char*>(base), bytes, advice);
+    }
+
+private:
+    void swap(MappedFile& other) noexcept {
+        std::swap(fd, other.fd);
+        std::swap(base, other.base);
+        std::swap(bytes, other.bytes);
+    }
+
+    int fd = -1;
+    const char* base = nullptr;
+    size_t bytes = 0;
+};
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { if (f) std::fclose(f); }
+};
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+inline File openFile(const std::string& path, const char* mode) {
+    File f(std::fopen(path.c_str(), mode));
+    if (!f) throw std::runtime_error("static B-tree: cannot open " + path);
+    return f;
+}
+
+inline void writeBytes(std::FILE* f, const void* src, size_t bytes) {
+    if (bytes && std::fwrite(src, 1, bytes, f) != bytes) throw std::runtime_error("static B-tree: write failed");
+}
+
+inline void writeZeros(std::FILE* f, size_t bytes) {
+    static const char zeros[4096] = {};
+    for (size_t chunk; bytes > 0; bytes -= chunk) {
+        chunk = std::min(bytes, sizeof(zeros));
+        writeBytes(f, zeros, chunk);
+    }
+}
+
+inline uint64_t roundUp(uint64_t x, uint64_t to) {
+    return (x + to - 1) / to * to;
+}
+
+} // namespace static_b_tree_detail
+
+template <typename T, typename Compare = std::less<>>
+class StaticBTree {
+    static_assert(std::is_trivially_copyable<T>::value, "records are read straight from the file");
+
+public:
+    // Builds the index file for the sorted data file in one sequential pass.
+    // Throws std::runtime_error if the data is not sorted by cmp.
+    static void build(const std::string& dataPath, const std::string& indexPath, size_t pageSize = 4096,
+                      Compare cmp = Compare()) {
+        using namespace static_b_tree_detail;
+        if (pageSize < sizeof(T) || pageSize % alignof(T) != 0) {
+            throw std::invalid_argument("static B-tree: page size does not fit the record");
+        }
+        const size_t fanout = pageSize / sizeof(T);
+
+        // Bottom index level: the last key of every leaf.
+        std::vector<std::vector<T>> levels(1);
+        uint64_t count = 0;
+        {
+            File in = openFile(dataPath, "rb");
+            std::vector<T> block(fanout * 256);
+            bool havePrev = false;
+            T prev{};
+            for (;;) {
+                size_t got = std::fread(block.data(), sizeof(T), block.size(), in.get());
+                if (got != block.size() && std::ferror(in.get())) throw std::runtime_error("static B-tree: read failed");
+                for (size_t i = 0; i < got; ++i) {
+                    if (havePrev && cmp(block[i], prev)) throw std::runtime_error("static B-tree: data file is not sorted");
+                    prev = block[i];
+                    havePrev = true;
+                    if (++count % fanout == 0) levels[0].push_back(prev);
+                }
+                if (got < block.size()) break;
+            }
+            if (count % fanout != 0) levels[0].push_back(prev);
+            long long tail = std::ftell(in.get());
+            if (tail < 0 || static_cast<uint64_t>(tail) != count * sizeof(T)) {
+                throw std::runtime_error("static B-tree: file size is not a multiple of the record size");
+            }
+        }
+        if (count == 0) levels.clear();
+        // Each level above holds the last entry of every node of the level below.
+        while (!levels.empty() && levels.back().size() > 1) {
+            const std::vector<T>& below = levels.back();
+            std::vector<T> above;
+            for (size_t i = fanout; i < below.size() + fanout; i += fanout) above.push_back(below[std::min(i, below.size()) - 1]);
+            levels.push_back(std::move(above));
+        }
+        std::reverse(levels.begin(), levels.end());
+        if (levels.size() > kMaxLevels) throw std::runtime_error("static B-tree: too many levels");
+
+        Header h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.keySize = sizeof(T);
+        h.count = count;
+        h.pageSize = pageSize;
+        h.fanout = fanout;
+        h.levels = levels.size();
+        uint64_t offset = roundUp(sizeof(Header), pageSize);
+        for (size_t l = 0; l < levels.size(); ++l) {
+            h.levelOffset[l] = offset;
+            h.levelSize[l] = levels[l].size();
+            offset = roundUp(offset + levels[l].size() * sizeof(T), pageSize);
+        }
+
+        File out = openFile(indexPath, "wb");
+        writeBytes(out.get(), &h, sizeof(h));
+        writeZeros(out.get(), roundUp(sizeof(h), pageSize) - sizeof(h));
+        for (const std::vector<T>& level : levels) {
+            size_t bytes = level.size() * sizeof(T);
+            writeBytes(out.get(), level.data(), bytes);
+            writeZeros(out.get(), roundUp(bytes, pageSize) - bytes);
+        }
+        if (std::fflush(out.get()) != 0) throw std::runtime_error("static B-tree: flush failed");
+    }
+
+    // Maps a data file and its index. Nothing is read up front except the
+    // index header; the index is handed to the kernel's readahead, and the
+    // data file is marked for random access so a lookup does not drag in
+    // neighbouring pages.
+    StaticBTree(const std::string& dataPath, const std::string& indexPath, Compare cmp = Compare())
+        : cmp(std::move(cmp)), dataFile(dataPath), indexFile(indexPath) {
+        using namespace static_b_tree_detail;
+        if (indexFile.size() < sizeof(Header)) throw std::runtime_error("static B-tree: index file too short");
+        std::memcpy(&header, indexFile.data(), sizeof(Header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.keySize != sizeof(T) ||
+            header.levels > kMaxLevels || header.fanout == 0) {
+            throw std::runtime_error("static B-tree: not an index for this record type");
+        }
+        if (header.count * sizeof(T) != dataFile.size()) {
+            throw std::runtime_error("static B-tree: data file does not match its index");
+        }
+        for (size_t l = 0; l < header.levels; ++l) {
+            if (header.levelOffset[l] + header.levelSize[l] * sizeof(T) > indexFile.size()) {
+                throw std::runtime_error("static B-tree: index file truncated");
+            }
+        }
+        records = reinterpret_cast<const T*>(dataFile.data());
+        n = header.count;
+        fanout = header.fanout;
+        indexFile.advise(MADV_WILLNEED);
+        dataFile.advise(MADV_RANDOM);
+    }
+
+    size_t size() const { return n; }
+
+    // Index levels above the data; a lookup reads one page of each, then one
+    // leaf.
+    size_t levels() const { return header.levels; }
+
+    // The mapped records, in sorted order.
+    const T* data() const { return records; }
+    const T& at(size_t r) const { return records[r]; }
+
+    // Number of records less than x, i.e. the std::lower_bound position in the
+    // data file.
+    size_t lowerBound(const T& x) const {
+        if (n == 0) return 0;
+        size_t node = 0;
+        for (size_t l = 0; l < header.levels; ++l) {
+            node = searchNode(l, node, x);
+            if (node == kPastEnd) return n;
+        }
+        return searchLeaf(node, x);
+    }
+
+    bool contains(const T& x) const {
+        size_t r = lowerBound(x);
+        return r < n && !cmp(x, records[r]);
+    }
+
+    // lowerBound as a state machine for interleavedSearch (see
+    // Binary_Search/binary_search.h): one page per step. The next page is
+    // prefetched, which overlaps cache misses of resident pages; pages that
+    // are not resident still fault in one at a time.
+    using Key = T;
+    struct State {
+        size_t level; // levels() once at the leaf
+        size_t pos;   // Node to search, then the result
+        T key;
+    };
+
+    void start(State& s, const T& key) const {
+        s.level = 0;
+        s.pos = 0;
+        s.key = key;
+        if (n == 0) {
+            s.level = header.levels + 1;
+            return;
+        }
+        prefetchNode(0, 0);
+    }
+
+    bool step(State& s) const {
+        if (s.level > header.levels) return true;
+        if (s.level == header.levels) {
+            s.pos = searchLeaf(s.pos, s.key);
+            s.level = header.levels + 1;
+            return true;
+        }
+        s.pos = searchNode(s.level, s.pos, s.key);
+        if (s.pos == kPastEnd) {
+            s.pos = n;
+            s.level = header.levels + 1;
+            return true;
+        }
+        ++s.level;
+        prefetchNode(s.level, s.pos);
+        return false;
+    }
+
+    size_t result(const State& s) const { return s.pos; }
+
+private:
+    static constexpr size_t kPastEnd = ~size_t(0);
+
+    const T* level(size_t l) const {
+        return reinterpret_cast<const T*>(indexFile.data() + header.levelOffset[l]);
+    }
+
+    // Entry in level l of the first key >= x inside the given node, which is
+    // also the child node to descend into; kPastEnd if x is larger than every
+    // key (only possible at the root).
+    size_t searchNode(size_t l, size_t node, const T& x) const {
+        const T* keys = level(l);
+        size_t begin = node * fanout, end = std::min<size_t>(begin + fanout, header.levelSize[l]);
+        size_t pos = static_cast<size_t>(::lowerBound(keys + begin, keys + end, x, cmp) - keys);
+        return pos == end ? kPastEnd : pos;
+    }
+
+    size_t searchLeaf(size_t leaf, const T& x) const {
+        size_t begin = leaf * fanout, end = std::min(begin + fanout, n);
+        return static_cast<size_t>(::lowerBound(records + begin, records + end, x, cmp) - records);
+    }
+
+    // Prefetches the middle of the node to search in level l (the leaves when
+    // l == levels()), the first probe of the in-page binary search.
+    void prefetchNode(size_t l, size_t node) const {
+        if (l < header.levels) {
+            size_t begin = node * fanout, end = std::min<size_t>(begin + fanout, header.levelSize[l]);
+            __builtin_prefetch(level(l) + begin + (end - begin) / 2);
+        } else {
+            size_t begin = node * fanout, end = std::min(begin + fanout, n);
+            __builtin_prefetch(records + begin + (end - begin) / 2);
+        }
+    }
+
+    Compare cmp;
+    static_b_tree_detail::MappedFile dataFile;
+    static_b_tree_detail::MappedFile indexFile;
+    static_b_tree_detail::Header header{};
+    const T* records = nullptr;
+    size_t n = 0;
+    size_t fanout = 1;
+};
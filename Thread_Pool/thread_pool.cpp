@@ -0,0 +1,24 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include "thread_pool.h"
+using namespace std;
+
+int main() {
+    ThreadPool& pool = defaultThreadPool();
+
+    const size_t n = 10000000;
+    vector<long long> values(n);
+    pool.parallelFor(n, [&](size_t i) { values[i] = (long long)(i % 1000) * (i % 1000); }, 1 << 16);
+
+    // One partial sum per block, combined on the calling thread
+    const size_t blocks = 64;
+    vector<long long> partial(blocks, 0);
+    pool.parallelFor(blocks, [&](size_t b) {
+        for (size_t i = b * n / blocks; i < (b + 1) * n / blocks; ++i) partial[b] += values[i];
+    });
+
+    cout << "Threads: " << pool.size() << endl;
+    cout << "Sum of squares: " << accumulate(partial.begin(), partial.end(), 0LL) << endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads shared by the parallel algorithms in this
+// repository. Work is submitted either as fire-and-forget tasks or as a
+// blocking parallelFor in which the calling thread also takes part.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency()) {
+        numThreads = std::max<size_t>(1, numThreads);
+        // The caller of parallelFor is the extra worker, so spawn one fewer.
+        for (size_t i = 1; i < numThreads; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads that execute a parallelFor, including the caller.
+    size_t size() const { return workers.size() + 1; }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+    // Calls fn(i) for every i in [0, count) and returns once all calls are done.
+    // Indices are claimed dynamically in blocks of `grain`. The caller works
+    // too, so nested calls from inside a task cannot deadlock the pool.
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn, size_t grain = 1) {
+        if (count == 0) return;
+        grain = std::max<size_t>(1, grain);
+        size_t blocks = (count + grain - 1) / grain;
+        if (blocks == 1 || workers.empty()) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        struct Shared {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::mutex m;
+            std::condition_variable finished;
+        };
+        auto shared = std::make_shared<Shared>();
+        auto run = [shared, &fn, count, grain, blocks] {
+            size_t b;
+            while ((b = shared->next.fetch_add(1)) < blocks) {
+                size_t end = std::min(count, (b + 1) * grain);
+                for (size_t i = b * grain; i < end; ++i) fn(i);
+                if (shared->done.fetch_add(1) + 1 == blocks) {
+                    std::lock_guard<std::mutex> lock(shared->m);
+                    shared->finished.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(workers.size(), blocks - 1);
+        for (size_t h = 0; h < helpers; ++h) submit(run);
+        run();
+
+        // Helpers that start after all blocks are claimed return immediately,
+        // so waiting on the block counter (not the helpers) is sufficient.
+        std::unique_lock<std::mutex> lock(shared->m);
+        shared->finished.wait(lock, [&] { return shared->done.load() == blocks; });
+    }
+
+private:
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+};
+
+// Process-wide pool sized to the machine, created on first use.
+inline ThreadPool& defaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
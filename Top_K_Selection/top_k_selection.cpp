@@ -0,0 +1,59 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include "top_k_selection.h"
+using namespace std;
+
+struct Request {
+    double latencyMs;
+    int id;
+};
+
+template <typename Fn>
+double timeMs(Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    // The 3rd smallest element of a small array
+    vector<int> arr = {10, 7, 8, 9, 1, 5};
+    introSelect(arr.begin(), arr.begin() + 2, arr.end());
+    cout << "3rd smallest of {10, 7, 8, 9, 1, 5}: " << arr[2] << endl;
+
+    // Latency percentiles of 10 million requests
+    const size_t n = 10000000;
+    mt19937_64 rng(7);
+    lognormal_distribution<double> latency(1.0, 0.8);
+    vector<double> latencies(n);
+    for (auto& x : latencies) x = latency(rng);
+
+    vector<double> a = latencies, b = latencies;
+    vector<double> p;
+    double selectMs = timeMs([&] { p = quantiles(a.begin(), a.end(), {0.5, 0.9, 0.99, 0.999}); });
+    double sortMs = timeMs([&] { sort(b.begin(), b.end()); });
+    cout << "p50 / p90 / p99 / p99.9 latency (ms): " << p[0] << " / " << p[1] << " / " << p[2] << " / " << p[3] << endl;
+    cout << "  multiSelect: " << selectMs << " ms, full sort: " << sortMs << " ms" << endl;
+    cout << "  Matches sorted order: "
+         << (p[2] == b[static_cast<size_t>(0.99 * (n - 1) + 0.5)] ? "yes" : "no") << endl;
+
+    // Slowest 5 requests of an unbounded stream, keeping only 5 in memory
+    auto slower = [](const Request& x, const Request& y) { return x.latencyMs < y.latencyMs; };
+    TopK<Request, decltype(slower)> slowest(5, slower);
+    for (int id = 0; id < 1000000; ++id) slowest.push(Request{latency(rng), id});
+    cout << "Slowest 5 of a stream of 1000000 requests:";
+    for (const Request& r : slowest.take()) cout << " #" << r.id << " (" << r.latencyMs << " ms)";
+    cout << endl;
+
+    // Top 1000 with per-thread heaps
+    vector<double> top;
+    double parallelMs = timeMs([&] { top = parallelTopK(latencies.begin(), latencies.end(), 1000); });
+    cout << "parallelTopK(1000) on " << defaultThreadPool().size() << " thread(s): " << parallelMs << " ms, "
+         << "largest " << top.front() << ", 1000th " << top.back()
+         << (top.back() == b[n - 1000] ? " (matches sorted order)" : " (MISMATCH)") << endl;
+    return 0;
+}
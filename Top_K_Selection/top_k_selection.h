@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "../Insertion_Sort/insertion_sort.h"
+#include "../Quick_Sort/quick_sort.h"
+#include "../Thread_Pool/thread_pool.h"
+
+// Order statistics and top-k without a full sort.
+//
+// - introSelect: nth_element built from the quicksort engine's pivot choice,
+//   block partition and fat partition for duplicates. Expected O(n); once the
+//   depth budget of 2*log2(n) partitions is used up, pivots switch to median
+//   of medians, which bounds the worst case at O(n).
+// - multiSelect: several ranks at once (e.g. p50, p90, p99), splitting the
+//   range so each partition serves every rank inside it.
+// - TopK: bounded heap for streams of unknown length, O(log k) per accepted
+//   element and one comparison per rejected one.
+// - parallelTopK: one TopK per block on a ThreadPool, merged at the end.
+namespace top_k_detail {
+
+constexpr ptrdiff_t kSelectInsertionCutoff = 16;
+
+template <typename T, typename Compare>
+void introSelectLoop(T* lo, T* nth, T* hi, int depthLimit, bool leftmost, Compare& cmp);
+
+// Moves a median-of-medians pivot (groups of 5) to *lo. At least 3/10 of the
+// range is on either side of it, which is what guarantees linear time.
+template <typename T, typename Compare>
+void medianOfMedians(T* lo, T* hi, bool leftmost, Compare& cmp) {
+    ptrdiff_t groups = (hi - lo) / 5;
+    for (ptrdiff_t g = 0; g < groups; ++g) {
+        T* group = lo + 5 * g;
+        insertionSort(group, group + 5, std::ref(cmp));
+        std::iter_swap(lo + g, group + 2);
+    }
+    // Every element of [lo, hi) is still >= *(lo - 1) when !leftmost.
+    introSelectLoop(lo, lo + groups / 2, lo + groups, 0, leftmost, cmp);
+    std::iter_swap(lo, lo + groups / 2);
+}
+
+// Puts the element of rank nth - lo into *nth, with [lo, nth) <= *nth <= (nth, hi).
+// When !leftmost, *(lo - 1) is <= every element of [lo, hi), as in introSortLoop.
+template <typename T, typename Compare>
+void introSelectLoop(T* lo, T* nth, T* hi, int depthLimit, bool leftmost, Compare& cmp) {
+    while (hi - lo > kSelectInsertionCutoff) {
+        if (depthLimit == 0) {
+            medianOfMedians(lo, hi, leftmost, cmp);
+        } else {
+            --depthLimit;
+            quick_sort_detail::choosePivot(lo, hi, cmp);
+        }
+
+        if (!leftmost && !cmp(*(lo - 1), *lo)) {
+            T* greater = quick_sort_detail::partitionEqual(lo, hi, cmp);
+            if (nth < greater) return; // nth is one of the copies of the pivot
+            lo = greater;
+            continue;
+        }
+
+        T* p = quick_sort_detail::blockPartition(lo, hi, cmp);
+        if (p == nth) return;
+        if (nth < p) {
+            hi = p;
+        } else {
+            lo = p + 1;
+            leftmost = false;
+        }
+    }
+    insertionSort(lo, hi, std::ref(cmp));
+}
+
+template <typename T, typename Compare>
+void multiSelectLoop(T* lo, T* hi, const size_t* rankLo, const size_t* rankHi, T* base,
+                     int depthLimit, bool leftmost, Compare& cmp) {
+    if (rankLo == rankHi) return;
+    const size_t* mid = rankLo + (rankHi - rankLo) / 2;
+    T* nth = base + *mid;
+    introSelectLoop(lo, nth, hi, depthLimit, leftmost, cmp);
+    multiSelectLoop(lo, nth, rankLo, mid, base, depthLimit, leftmost, cmp);
+    multiSelectLoop(nth + 1, hi, mid + 1, rankHi, base, depthLimit, false, cmp);
+}
+
+inline int depthLimitFor(ptrdiff_t n) {
+    int depthLimit = 0;
+    for (ptrdiff_t k = n; k > 1; k >>= 1) depthLimit += 2;
+    return depthLimit;
+}
+
+} // namespace top_k_detail
+
+// Rearranges the contiguous range [first, last) like std::nth_element: *nth
+// becomes the element that would be there if the range were sorted, nothing
+// before it is greater and nothing after it is smaller. O(n) worst case.
+template <typename RandomIt, typename Compare = std::less<>>
+void introSelect(RandomIt first, RandomIt nth, RandomIt last, Compare cmp = Compare()) {
+    ptrdiff_t n = last - first;
+    if (n < 2 || nth == last) return;
+    auto* lo = &*first;
+    top_k_detail::introSelectLoop(lo, lo + (nth - first), lo + n, top_k_detail::depthLimitFor(n), true, cmp);
+}
+
+// Places the elements of every rank in `ranks` (indices into [first, last))
+// at their sorted positions. Ranks outside the range are ignored.
+template <typename RandomIt, typename Compare = std::less<>>
+void multiSelect(RandomIt first, RandomIt last, std::vector<size_t> ranks, Compare cmp = Compare()) {
+    size_t n = static_cast<size_t>(last - first);
+    ranks.erase(std::remove_if(ranks.begin(), ranks.end(), [n](size_t r) { return r >= n; }), ranks.end());
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    if (n < 2 || ranks.empty()) return;
+    auto* lo = &*first;
+    top_k_detail::multiSelectLoop(lo, lo + n, ranks.data(), ranks.data() + ranks.size(), lo,
+                                  top_k_detail::depthLimitFor(static_cast<ptrdiff_t>(n)), true, cmp);
+}
+
+// Nearest-rank quantiles, e.g. {0.5, 0.99} for p50 and p99. Reorders the range.
+template <typename RandomIt, typename Compare = std::less<>>
+std::vector<typename std::iterator_traits<RandomIt>::value_type>
+quantiles(RandomIt first, RandomIt last, const std::vector<double>& qs, Compare cmp = Compare()) {
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> result;
+    size_t n = static_cast<size_t>(last - first);
+    if (n == 0) return result;
+    std::vector<size_t> ranks;
+    for (double q : qs) ranks.push_back(static_cast<size_t>(std::clamp(q, 0.0, 1.0) * double(n - 1) + 0.5));
+    multiSelect(first, last, ranks, cmp);
+    for (size_t r : ranks) result.push_back(first[r]);
+    return result;
+}
+
+// Keeps the k greatest elements (by cmp) seen so far. The kept elements form a
+// min-heap, so the weakest of them is checked first and most elements of a
+// long stream are rejected with a single comparison. An element equal to the
+// threshold does not replace it.
+template <typename T, typename Compare = std::less<>>
+class TopK {
+public:
+    explicit TopK(size_t k, Compare cmp = Compare()) : k(k), cmp(std::move(cmp)) { heap.reserve(k); }
+
+    size_t size() const { return heap.size(); }
+    size_t capacity() const { return k; }
+    bool full() const { return heap.size() == k; }
+
+    // Weakest element kept; only valid when size() > 0.
+    const T& threshold() const { return heap.front(); }
+
+    void push(const T& x) {
+        if (heap.size() < k) {
+            heap.push_back(x);
+            siftUp(heap.size() - 1);
+        } else if (k > 0 && cmp(heap.front(), x)) {
+            heap.front() = x;
+            siftDown(0);
+        }
+    }
+
+    template <typename It>
+    void push(It first, It last) {
+        for (; first != last; ++first) push(*first);
+    }
+
+    void merge(const TopK& other) {
+        for (const T& x : other.heap) push(x);
+    }
+
+    // The kept elements, greatest first. Leaves this object empty.
+    std::vector<T> take() {
+        std::vector<T> out = std::move(heap);
+        heap.clear();
+        std::sort(out.begin(), out.end(), [this](const T& a, const T& b) { return cmp(b, a); });
+        return out;
+    }
+
+private:
+    // Min-heap on cmp: a parent is never greater than its children.
+    void siftUp(size_t i) {
+        T x = std::move(heap[i]);
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!cmp(x, heap[parent])) break;
+            heap[i] = std::move(heap[parent]);
+            i = parent;
+        }
+        heap[i] = std::move(x);
+    }
+
+    void siftDown(size_t i) {
+        size_t n = heap.size();
+        T x = std::move(heap[i]);
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && cmp(heap[child + 1], heap[child])) ++child;
+            if (!cmp(heap[child], x)) break;
+            heap[i] = std::move(heap[child]);
+            i = child;
+        }
+        heap[i] = std::move(x);
+    }
+
+    size_t k;
+    Compare cmp;
+    std::vector<T> heap;
+};
+
+// The k greatest elements of [first, last), greatest first, computed with one
+// TopK per block on the pool and merged at the end.
+template <typename RandomIt, typename Compare = std::less<>>
+std::vector<typename std::iterator_traits<RandomIt>::value_type>
+parallelTopK(RandomIt first, RandomIt last, size_t k, Compare cmp = Compare(),
+             ThreadPool& pool = defaultThreadPool()) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    size_t n = static_cast<size_t>(last - first);
+    size_t blocks = std::max<size_t>(1, std::min(pool.size() * 4, n / std::max<size_t>(k, 4096)));
+    auto bound = [n, blocks](size_t b) { return b * n / blocks; };
+
+    std::vector<TopK<T, Compare>> partial(blocks, TopK<T, Compare>(k, cmp));
+    pool.parallelFor(blocks, [&](size_t b) {
+        partial[b].push(first + bound(b), first + bound(b + 1));
+    });
+    for (size_t b = 1; b < blocks; ++b) partial[0].merge(partial[b]);
+    return partial[0].take();
+}
@@ -1,50 +1,55 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include "union_find_algorithm.h"
 using namespace std;
 
-class UnionFind {
-private:
-    vector<int> parent, rank;
-
-public:
-    UnionFind(int size) {
-        parent.resize(size);
-        rank.resize(size, 0);
-        for (int i = 0; i < size; ++i) {
-            parent[i] = i;
-        }
-    }
-
-    int find(int x) {
-        if (x != parent[x]) {
-            parent[x] = find(parent[x]); // Path compression
-        }
-        return parent[x];
-    }
-
-    void unionSets(int x, int y) {
-        int rootX = find(x);
-        int rootY = find(y);
-
-        if (rootX != rootY) {
-            if (rank[rootX] > rank[rootY]) {
-                parent[rootY] = rootX;
-            } else if (rank[rootX] < rank[rootY]) {
-                parent[rootX] = rootY;
-            } else {
-                parent[rootY] = rootX;
-                rank[rootX]++;
-            }
-        }
-    }
-};
-
 int main() {
     UnionFind uf(10);
     uf.unionSets(1, 2);
     uf.unionSets(2, 3);
     cout << "Find(1): " << uf.find(1) << endl;
     cout << "Find(3): " << uf.find(3) << endl;
+
+    // A stream of 2^24 random unions over 2^22 elements, in batches of 2^20
+    const size_t n = size_t(1) << 22, batchSize = size_t(1) << 20, batches = 16;
+    mt19937_64 rng(31);
+    vector<vector<pair<uint32_t, uint32_t>>> stream(batches, vector<pair<uint32_t, uint32_t>>(batchSize));
+    for (auto& batch : stream) {
+        for (auto& e : batch) e = {uint32_t(rng() % n), uint32_t(rng() % n)};
+    }
+    cout << "Stream: " << batches << " batches of " << batchSize << " unions over " << n << " elements" << endl;
+
+    auto since = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    auto start = chrono::steady_clock::now();
+    UnionFind sequential(n);
+    for (const auto& batch : stream) {
+        for (const auto& [x, y] : batch) sequential.unionSets(x, y);
+    }
+    size_t expected = 0;
+    for (size_t x = 0; x < n; ++x) expected += sequential.find(x) == int(x);
+    cout << "  UnionFind:                     " << since(start) << " ms, " << expected << " sets" << endl;
+
+    for (size_t threads : {1, 2, 4}) {
+        ThreadPool pool(threads);
+        start = chrono::steady_clock::now();
+        ConcurrentUnionFind<uint32_t> sets(n, pool);
+        // Every thread takes whole batches and calls uniteBatch on its own
+        atomic<size_t> next{0};
+        pool.parallelFor(pool.size(), [&](size_t) {
+            for (size_t b; (b = next.fetch_add(1)) < batches;) sets.uniteBatch(stream[b]);
+        });
+        vector<uint32_t> label = sets.labels(pool);
+        double ms = since(start);
+        size_t found = 0;
+        for (size_t x = 0; x < n; ++x) found += label[x] == x;
+        cout << "  ConcurrentUnionFind, " << threads << " thread" << (threads > 1 ? "s: " : ":  ") << ms << " ms, "
+             << found << " sets" << endl;
+    }
     return 0;
 }
-
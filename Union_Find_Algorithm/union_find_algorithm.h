@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../Thread_Pool/thread_pool.h"
+
+// Disjoint sets over the elements 0..size-1, with union by rank and path
+// compression.
+class UnionFind {
+private:
+    std::vector<int> parent, rank;
+
+public:
+    UnionFind(int size) {
+        parent.resize(size);
+        rank.resize(size, 0);
+        for (int i = 0; i < size; ++i) {
+            parent[i] = i;
+        }
+    }
+
+    // Two passes instead of recursion, so a long chain cannot overflow the
+    // stack: find the root, then point every element on the way at it.
+    int find(int x) {
+        int root = x;
+        while (root != parent[root]) root = parent[root];
+        while (x != root) {
+            int next = parent[x];
+            parent[x] = root; // Path compression
+            x = next;
+        }
+        return root;
+    }
+
+    // Returns false if x and y were already in the same set.
+    bool unionSets(int x, int y) {
+        int rootX = find(x);
+        int rootY = find(y);
+
+        if (rootX == rootY) return false;
+        if (rank[rootX] > rank[rootY]) {
+            parent[rootY] = rootX;
+        } else if (rank[rootX] < rank[rootY]) {
+            parent[rootX] = rootY;
+        } else {
+            parent[rootY] = rootX;
+            rank[rootX]++;
+        }
+        return true;
+    }
+};
+
+// Disjoint sets that many threads can find and unite at the same time,
+// without locks.
+//
+// - Linking by index: a root is only ever linked under a root with a smaller
+//   index, with a compare-and-swap that fails if it stopped being a root in
+//   the meantime (the union then retries from the new roots). Parents only
+//   decrease, so no cycle can form, and the representative of a finished set
+//   is its smallest element.
+// - Path halving: find points every other element on its way at its
+//   grandparent. Any ancestor is a correct parent, so these writes are
+//   relaxed compare-and-swaps that may lose to a concurrent one and are
+//   simply skipped then.
+//
+// No other memory is published through the parent array, so all accesses are
+// relaxed; results are read after the parallel section has joined.
+template <typename Id = uint32_t>
+class ConcurrentUnionFind {
+    static_assert(std::is_unsigned<Id>::value, "unsigned ids");
+
+public:
+    explicit ConcurrentUnionFind(size_t n, ThreadPool& pool = defaultThreadPool()) : parent(n) {
+        pool.parallelFor(n, [&](size_t x) { parent[x].store(static_cast<Id>(x), std::memory_order_relaxed); }, 4096);
+    }
+
+    size_t size() const { return parent.size(); }
+
+    Id find(Id x) {
+        while (true) {
+            Id p = parent[x].load(std::memory_order_relaxed);
+            if (p == x) return x;
+            Id g = parent[p].load(std::memory_order_relaxed);
+            if (g == p) return p;
+            parent[x].compare_exchange_weak(p, g, std::memory_order_relaxed);
+            x = g;
+        }
+    }
+
+    // Returns false if x and y were already in the same set.
+    bool unite(Id x, Id y) {
+        while (true) {
+            x = find(x);
+            y = find(y);
+            if (x == y) return false;
+            if (x < y) std::swap(x, y);
+            Id root = x;
+            if (parent[x].compare_exchange_strong(root, y, std::memory_order_relaxed)) return true;
+        }
+    }
+
+    bool sameSet(Id x, Id y) {
+        while (true) {
+            x = find(x);
+            y = find(y);
+            if (x == y) return true;
+            // x and y were roots a moment ago; if x still is, they differ
+            if (parent[x].load(std::memory_order_relaxed) == x) return false;
+        }
+    }
+
+    // Unites the two ends of every edge. Any number of threads may call this
+    // at once, each with its own batch.
+    void uniteBatch(const std::vector<std::pair<Id, Id>>& edges) {
+        for (const auto& [x, y] : edges) unite(x, y);
+    }
+
+    // The same, with one batch spread over the pool.
+    void uniteBatch(const std::vector<std::pair<Id, Id>>& edges, ThreadPool& pool) {
+        pool.parallelFor(edges.size(), [&](size_t i) { unite(edges[i].first, edges[i].second); }, 4096);
+    }
+
+    // Points every element straight at its root, so that the next find is
+    // one step. Must not run concurrently with unite.
+    void flatten(ThreadPool& pool = defaultThreadPool()) {
+        pool.parallelFor(parent.size(), [&](size_t x) {
+            parent[x].store(find(static_cast<Id>(x)), std::memory_order_relaxed);
+        }, 4096);
+    }
+
+    // The representative (smallest element) of every element's set. Must not
+    // run concurrently with unite.
+    std::vector<Id> labels(ThreadPool& pool = defaultThreadPool()) {
+        std::vector<Id> label(parent.size());
+        pool.parallelFor(parent.size(), [&](size_t x) { label[x] = find(static_cast<Id>(x)); }, 4096);
+        return label;
+    }
+
+private:
+    std::vector<std::atomic<Id>> parent;
+};